@@ -1,5 +1,247 @@
 #include <GOFSM/gofsm.h>
 
+#ifdef GOFSM_PROFILE_ENABLED
+#include <GOFSM/gofsm_profile.h>
+// Замер оператора в гистограмму профиля текущего потока
+#define GOFSM_PROFILE(histogram, statement) do{                                \
+	GOFSM_Profile_t* profile_ = GOFSM_Profile_Current();                       \
+	if(profile_==NULL){ statement; break; }                                    \
+	uint32_t start_ = GOFSM_PROFILE_CLOCK();                                   \
+	statement;                                                                 \
+	GOFSM_Histogram_Record(&profile_->histogram, GOFSM_PROFILE_CLOCK()-start_); \
+}while(0)
+// Замер функции перехода: в общую гистограмму и в гистограмму этой функции
+#define GOFSM_PROFILE_FUNCTION(key, statement) do{                             \
+	GOFSM_Profile_t* profile_ = GOFSM_Profile_Current();                       \
+	if(profile_==NULL){ statement; break; }                                    \
+	uint32_t start_ = GOFSM_PROFILE_CLOCK();                                   \
+	statement;                                                                 \
+	uint32_t elapsed_ = GOFSM_PROFILE_CLOCK()-start_;                          \
+	GOFSM_Histogram_Record(&profile_->function, elapsed_);                     \
+	GOFSM_Profile_RecordFunction(profile_, key, elapsed_);                     \
+}while(0)
+#else
+#define GOFSM_PROFILE(histogram, statement) do{ statement; }while(0)
+#define GOFSM_PROFILE_FUNCTION(key, statement) do{ statement; }while(0)
+#endif
+
+#if !defined(GOFSM_USDT_DISABLED) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define GOFSM_USDT_ENABLED
+#endif
+#endif
+
+#ifdef GOFSM_USDT_ENABLED
+#include <sys/sdt.h>
+// Точка трассировки gofsm:name — одна инструкция nop, аргументы читаются трассировщиком
+#define GOFSM_PROBE(name, ...) STAP_PROBEV(gofsm, name, __VA_ARGS__)
+#else
+#define GOFSM_PROBE(name, ...) ((void)0)
+#endif
+
+#define GOFSM_NEXT_HOP_NONE 0xFF
+
+#define GOFSM_BITMAP_SET(map, i) ((map)[(i)>>3] |= (uint8_t)(1u<<((i)&7)))
+#define GOFSM_BITMAP_GET(map, i) ((map)[(i)>>3] & (1u<<((i)&7)))
+
+// Разметка alg_ext_buffer
+#define GOFSM_EXT_NEXT_HOP(gofsm) ((gofsm)->alg_ext_buffer)
+#define GOFSM_EXT_OFFSETS(gofsm)  ((gofsm)->alg_ext_buffer+(gofsm)->nodes_capacity)
+#define GOFSM_EXT_EDGES(gofsm)    ((gofsm)->alg_ext_buffer+2*(gofsm)->nodes_capacity+1)
+#define GOFSM_EXT_DESTINATIONS(gofsm) (GOFSM_EXT_EDGES(gofsm)+(gofsm)->transitions_capacity)
+
+// На x86 (GCC/Clang) все варианты ядра собираются в одном бинарнике, выбор по CPUID при первой инициализации.
+// На остальных платформах вариант определяется при компиляции
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GOFSM_KERNEL_DISPATCH
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define GOFSM_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+// Маска совпадений node среди 64 байт назначений (бит i — байт i).
+// SWAR: 8 назначений в одном 64-битном слове
+static uint64_t GOFSM_Match_Scalar(const uint8_t* destinations, GOFSM_Node_Index_t node){
+	const uint64_t ones = 0x0101010101010101ull;
+	const uint64_t low7 = 0x7F7F7F7F7F7F7F7Full;
+	uint64_t mask = 0;
+	for(uint8_t i=0; i<8; i++){
+		uint64_t word;
+		memcpy(&word, destinations+8*i, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+		word = __builtin_bswap64(word);
+#endif
+		uint64_t x = word ^ (ones*node);
+		// старший бит выставлен ровно в нулевых байтах
+		uint64_t zero = ~(((x & low7) + low7) | x | low7);
+		mask |= (((zero >> 7) * 0x0102040810204080ull) >> 56) << (8*i);
+	}
+	return mask;
+}
+
+#ifdef GOFSM_KERNEL_DISPATCH
+__attribute__((target("sse2")))
+static uint64_t GOFSM_Match_SSE2(const uint8_t* destinations, GOFSM_Node_Index_t node){
+	__m128i needle = _mm_set1_epi8((char)node);
+	uint64_t mask = 0;
+	for(uint8_t i=0; i<4; i++){
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(destinations+16*i));
+		mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)) << (16*i);
+	}
+	return mask;
+}
+
+__attribute__((target("avx2")))
+static uint64_t GOFSM_Match_AVX2(const uint8_t* destinations, GOFSM_Node_Index_t node){
+	__m256i needle = _mm256_set1_epi8((char)node);
+	uint32_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)destinations), needle));
+	uint32_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(destinations+32)), needle));
+	return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static uint64_t GOFSM_Match_AVX512(const uint8_t* destinations, GOFSM_Node_Index_t node){
+	return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)destinations), _mm512_set1_epi8((char)node));
+}
+
+static uint64_t (*GOFSM_Match)(const uint8_t*, GOFSM_Node_Index_t) = GOFSM_Match_Scalar;
+static GOFSM_Kernel_t GOFSM_Kernel = GOFSM_Kernel_Scalar;
+static uint8_t GOFSM_Kernel_Resolved = 0;
+
+static uint8_t GOFSM_Kernel_IsSupported(GOFSM_Kernel_t kernel){
+	__builtin_cpu_init();
+	switch(kernel){
+	case GOFSM_Kernel_Scalar: return 1;
+	case GOFSM_Kernel_SSE2:   return __builtin_cpu_supports("sse2") ? 1 : 0;
+	case GOFSM_Kernel_AVX2:   return __builtin_cpu_supports("avx2") ? 1 : 0;
+	case GOFSM_Kernel_AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") ? 1 : 0;
+	default:                  return 0;
+	}
+}
+
+static void GOFSM_Kernel_Apply(GOFSM_Kernel_t kernel){
+	switch(kernel){
+	case GOFSM_Kernel_SSE2:   GOFSM_Match = GOFSM_Match_SSE2;   break;
+	case GOFSM_Kernel_AVX2:   GOFSM_Match = GOFSM_Match_AVX2;   break;
+	case GOFSM_Kernel_AVX512: GOFSM_Match = GOFSM_Match_AVX512; break;
+	default:                  GOFSM_Match = GOFSM_Match_Scalar; break;
+	}
+	GOFSM_Kernel = kernel;
+	GOFSM_Kernel_Resolved = 1;
+}
+
+static void GOFSM_Kernel_Resolve(void){
+	if(GOFSM_Kernel_Resolved) return;
+	if(GOFSM_Kernel_IsSupported(GOFSM_Kernel_AVX512))    GOFSM_Kernel_Apply(GOFSM_Kernel_AVX512);
+	else if(GOFSM_Kernel_IsSupported(GOFSM_Kernel_AVX2)) GOFSM_Kernel_Apply(GOFSM_Kernel_AVX2);
+	else if(GOFSM_Kernel_IsSupported(GOFSM_Kernel_SSE2)) GOFSM_Kernel_Apply(GOFSM_Kernel_SSE2);
+	else                                                 GOFSM_Kernel_Apply(GOFSM_Kernel_Scalar);
+}
+#endif
+
+#ifdef GOFSM_KERNEL_NEON
+static uint64_t GOFSM_Match_NEON(const uint8_t* destinations, GOFSM_Node_Index_t node){
+	static const uint8_t weights[16] = {1,2,4,8,16,32,64,128,1,2,4,8,16,32,64,128};
+	uint8x16_t needle = vdupq_n_u8(node);
+	uint8x16_t weight = vld1q_u8(weights);
+	uint64_t mask = 0;
+	for(uint8_t i=0; i<4; i++){
+		uint8x16_t bits = vandq_u8(vceqq_u8(vld1q_u8(destinations+16*i), needle), weight);
+		uint64_t half = vaddv_u8(vget_low_u8(bits)) | ((uint64_t)vaddv_u8(vget_high_u8(bits)) << 8);
+		mask |= half << (16*i);
+	}
+	return mask;
+}
+static GOFSM_Kernel_t GOFSM_Kernel = GOFSM_Kernel_NEON;
+#elif !defined(GOFSM_KERNEL_DISPATCH)
+static GOFSM_Kernel_t GOFSM_Kernel = GOFSM_Kernel_Scalar;
+#endif
+
+static inline uint64_t GOFSM_MatchDestinations(const uint8_t* destinations, GOFSM_Node_Index_t node){
+#if defined(GOFSM_KERNEL_DISPATCH)
+	return GOFSM_Match(destinations, node);
+#elif defined(GOFSM_KERNEL_NEON)
+	if(GOFSM_Kernel==GOFSM_Kernel_NEON)
+		return GOFSM_Match_NEON(destinations, node);
+	return GOFSM_Match_Scalar(destinations, node);
+#else
+	return GOFSM_Match_Scalar(destinations, node);
+#endif
+}
+
+GOFSM_Kernel_t GOFSM_GetKernel(void){
+#ifdef GOFSM_KERNEL_DISPATCH
+	GOFSM_Kernel_Resolve();
+#endif
+	return GOFSM_Kernel;
+}
+GOFSM_Error_t GOFSM_SetKernel(GOFSM_Kernel_t kernel){
+#if defined(GOFSM_KERNEL_DISPATCH)
+	if(!GOFSM_Kernel_IsSupported(kernel))
+		return GOFSM_Error_KernelUnsupported;
+	GOFSM_Kernel_Apply(kernel);
+#elif defined(GOFSM_KERNEL_NEON)
+	if(kernel!=GOFSM_Kernel_Scalar && kernel!=GOFSM_Kernel_NEON)
+		return GOFSM_Error_KernelUnsupported;
+	GOFSM_Kernel = kernel;
+#else
+	if(kernel!=GOFSM_Kernel_Scalar)
+		return GOFSM_Error_KernelUnsupported;
+#endif
+	return GOFSM_Error_No;
+}
+
+// SoA-копия графа: байтовый массив назначений переходов. Перестраивается лениво после изменения
+// состава графа. Состояние перехода не копируется: переход может быть общим с другим автоматом,
+// который блокирует его через свой GOFSM_Transition_SetState, поэтому состояние читается по месту
+static void GOFSM_BuildSoa(GOFSM_t* gofsm){
+	uint8_t* destinations = GOFSM_EXT_DESTINATIONS(gofsm);
+	memset(destinations, 0, GOFSM_SOA_SIZE(gofsm->transitions_capacity));
+	for(uint8_t j=0; j<gofsm->transitions_count; j++)
+		destinations[j] = gofsm->transitions[j]->destination_node_index;
+	gofsm->is_soa_valid = 1;
+	gofsm->stats.kernel = GOFSM_Kernel;
+}
+
+// Маска доступных переходов [base, base+64) с назначением node
+static inline uint64_t GOFSM_Predecessors(GOFSM_t* gofsm, uint16_t base, GOFSM_Node_Index_t node){
+	uint64_t mask = 0;
+	if(gofsm->is_soa_valid){
+		// разыменовываются только переходы с подходящим назначением
+		mask = GOFSM_MatchDestinations(GOFSM_EXT_DESTINATIONS(gofsm)+base, node);
+		// хвост блока заполнен нулями и совпадает с нодой 0
+		if(gofsm->transitions_count-base<GOFSM_SOA_CHUNK)
+			mask &= (1ull<<(gofsm->transitions_count-base))-1;
+		for(uint64_t bits=mask; bits; bits&=bits-1){
+			uint8_t k = (uint8_t)__builtin_ctzll(bits);
+			if(gofsm->transitions[base+k]->state!=GOFSM_Transition_State_Available)
+				mask &= ~(1ull<<k);
+		}
+		return mask;
+	}
+	uint16_t end = base+GOFSM_SOA_CHUNK;
+	if(end>gofsm->transitions_count) end = gofsm->transitions_count;
+	for(uint16_t j=base; j<end; j++){
+		GOFSM_Transition_t* transition = gofsm->transitions[j];
+		if(transition->destination_node_index==node && transition->state==GOFSM_Transition_State_Available)
+			mask |= 1ull << (j-base);
+	}
+	return mask;
+}
+
+// Постановка ноды в план, если она ещё не посещена
+static inline void GOFSM_Scan_Plan(const GOFSM_t* gofsm, const GOFSM_Node_Index_t* visited, uint8_t* visited_length, GOFSM_Node_Index_t* planned, uint8_t* planned_length, GOFSM_Node_Index_t node){
+	if(*visited_length>=gofsm->nodes_capacity) return;
+	// определяем факт посещения
+	for(uint8_t k=0; k<*visited_length; k++)
+		if(visited[k]==node)
+			return;
+	planned[*planned_length] = node;
+	(*planned_length)++;
+	(*visited_length)++;
+}
+
 GOFSM_Transition_t* GOFSM_SearchNextStep(GOFSM_t* gofsm){
 	GOFSM_Node_Index_t target = gofsm->target_node_index;
 	GOFSM_Node_Index_t current = gofsm->current_node_index;
@@ -23,38 +265,331 @@ GOFSM_Transition_t* GOFSM_SearchNextStep(GOFSM_t* gofsm){
 		for(uint8_t i=0; i<working_length; i++){// пробегаем по нодам
 			GOFSM_Node_Index_t node = working[i];
 
-			// для каждой ноды надо найти соседей
-			for(uint8_t j=0; j<gofsm->transitions_count; j++){
-				GOFSM_Transition_t* transition = gofsm->transitions[j];
-				if(transition->destination_node_index==node){
-					if(transition->state==GOFSM_Transition_State_Available){
-						GOFSM_Node_Index_t prev_node = transition->source_node_index;
-
-						// предварительная проверка
-						if(prev_node==current)
-							return transition;
-
-						// определяем факт посещения
-						uint8_t is_visited = 0;
-						for(uint8_t k=0; k<visited_length; k++){
-							if(visited[k]==prev_node){
-								is_visited=1;
-								break;
-							}
-						}
-						if(!is_visited){
-							planned[planned_length] = prev_node;
-							planned_length++;
-							visited_length++;
-						}
+			// для каждой ноды надо найти соседей: маска доступных переходов с назначением node
+			for(uint16_t base=0; base<gofsm->transitions_count; base+=GOFSM_SOA_CHUNK){
+				uint64_t mask = GOFSM_Predecessors(gofsm, base, node);
+				while(mask){
+					GOFSM_Transition_t* transition = gofsm->transitions[base+__builtin_ctzll(mask)];
+					mask &= mask-1;
+					GOFSM_Node_Index_t prev_node = transition->source_node_index;
+
+					// предварительная проверка
+					if(GOFSM_Transition_IsSource(transition, current, gofsm->nodes_capacity)){
+						gofsm->stats.expanded = visited_length;
+						return transition;
+					}
+
+					if(!transition->is_any){
+						GOFSM_Scan_Plan(gofsm, visited, &visited_length, planned, &planned_length, prev_node);
+						continue;
 					}
+					// wildcard: неявные рёбра из всех разрешённых нод
+					for(uint16_t n=0; n<gofsm->nodes_capacity; n++)
+						if(GOFSM_Transition_IsSource(transition, n, gofsm->nodes_capacity))
+							GOFSM_Scan_Plan(gofsm, visited, &visited_length, planned, &planned_length, n);
 				}
 			}
 		}
 	}
+	gofsm->stats.expanded = visited_length;
 	return NULL;
 }
 
+// Индекс предшественников: переходы сгруппированы по ноде назначения (CSR),
+// внутри группы сохраняется порядок регистрации. Перестраивается только при добавлении/удалении переходов.
+static uint8_t GOFSM_BuildIndex(GOFSM_t* gofsm){
+	uint8_t* offsets = GOFSM_EXT_OFFSETS(gofsm);
+	uint8_t* edges = GOFSM_EXT_EDGES(gofsm);
+	uint8_t* cursor = GOFSM_EXT_NEXT_HOP(gofsm);
+	gofsm->is_table_valid = 0;
+
+	memset(offsets, 0, gofsm->nodes_capacity+1);
+	for(uint8_t j=0; j<gofsm->transitions_count; j++){
+		GOFSM_Transition_t* transition = gofsm->transitions[j];
+		if((transition->source_node_index>=gofsm->nodes_capacity && !transition->is_any)
+			|| transition->destination_node_index>=gofsm->nodes_capacity)
+			return 0;
+		offsets[transition->destination_node_index+1]++;
+	}
+	for(uint16_t i=0; i<gofsm->nodes_capacity; i++){
+		offsets[i+1] += offsets[i];
+		cursor[i] = offsets[i];
+	}
+	for(uint8_t j=0; j<gofsm->transitions_count; j++)
+		edges[cursor[gofsm->transitions[j]->destination_node_index]++] = j;
+	return 1;
+}
+
+typedef struct{
+	GOFSM_Node_Index_t current;
+	uint8_t* next_hop;
+	GOFSM_Node_Index_t* queue;
+	uint16_t tail;
+	uint8_t visited[GOFSM_NODES_BITMAP_SIZE];
+}GOFSM_Bfs_t;
+
+// Предшественник prev_node достигнут по переходу j. 1 — это текущая нода (поиск без таблицы)
+static inline uint8_t GOFSM_Bfs_Reach(GOFSM_t* gofsm, GOFSM_Bfs_t* bfs, GOFSM_Node_Index_t prev_node, uint8_t j){
+	if(GOFSM_BITMAP_GET(bfs->visited, prev_node)) return 0;
+	// очередь рассчитана на nodes_capacity нод
+	if(bfs->tail>=gofsm->nodes_capacity) return 0;
+	if(bfs->next_hop==NULL){
+		if(prev_node==bfs->current)
+			return 1;
+	}else{
+		bfs->next_hop[prev_node] = j;
+	}
+	GOFSM_BITMAP_SET(bfs->visited, prev_node);
+	bfs->queue[bfs->tail++] = prev_node;
+	return 0;
+}
+
+// Обработка доступного перехода j в ноду из очереди. 1 — найден переход из текущей ноды
+static inline uint8_t GOFSM_Bfs_Visit(GOFSM_t* gofsm, GOFSM_Bfs_t* bfs, uint8_t j){
+	GOFSM_Transition_t* transition = gofsm->transitions[j];
+	if(!transition->is_any)
+		return GOFSM_Bfs_Reach(gofsm, bfs, transition->source_node_index, j);
+
+	// wildcard: одна проверка текущей ноды, иначе неявные рёбра из всех разрешённых непосещённых нод
+	if(bfs->next_hop==NULL && GOFSM_Transition_IsSource(transition, bfs->current, gofsm->nodes_capacity))
+		return 1;
+	const uint8_t* source_set = ((GOFSM_Transition_Any_t*)transition)->source_set;
+	for(uint16_t byte=0; byte*8<gofsm->nodes_capacity; byte++){
+		uint8_t bits = (source_set!=NULL ? source_set[byte] : 0xFF) & ~bfs->visited[byte];
+		while(bits){
+			uint16_t node = byte*8+__builtin_ctz(bits);
+			bits &= bits-1;
+			if(node>=gofsm->nodes_capacity) break;
+			if(GOFSM_Bfs_Reach(gofsm, bfs, node, j))
+				return 1;
+		}
+	}
+	return 0;
+}
+
+// Обратный BFS с битовой картой посещённых.
+// next_hop==NULL: остановка на первом переходе из текущей ноды.
+// Иначе обход до конца с заполнением next_hop[нода] = индекс перехода (таблица до текущей цели).
+static GOFSM_Transition_t* GOFSM_SearchBitset(GOFSM_t* gofsm, GOFSM_Node_Index_t target, uint8_t use_index, uint8_t* next_hop){
+	const uint8_t* offsets = GOFSM_EXT_OFFSETS(gofsm);
+	const uint8_t* edges = GOFSM_EXT_EDGES(gofsm);
+
+	GOFSM_Bfs_t bfs = {
+		.current  = gofsm->current_node_index,
+		.next_hop = next_hop,
+		.queue    = gofsm->alg_nodes_buffer,
+	};
+	uint16_t head = 0;
+	bfs.queue[bfs.tail++] = target;
+	GOFSM_BITMAP_SET(bfs.visited, target);
+
+	while(head<bfs.tail){
+		GOFSM_Node_Index_t node = bfs.queue[head++];
+
+		if(use_index){
+			for(uint8_t k=offsets[node]; k<offsets[node+1]; k++){
+				uint8_t j = edges[k];
+				if(gofsm->transitions[j]->state!=GOFSM_Transition_State_Available) continue;
+				if(GOFSM_Bfs_Visit(gofsm, &bfs, j)){
+					gofsm->stats.expanded = (uint8_t)bfs.tail;
+					return gofsm->transitions[j];
+				}
+			}
+		}else{
+			for(uint16_t base=0; base<gofsm->transitions_count; base+=GOFSM_SOA_CHUNK){
+				uint64_t mask = GOFSM_Predecessors(gofsm, base, node);
+				while(mask){
+					uint8_t j = base+__builtin_ctzll(mask);
+					mask &= mask-1;
+					if(GOFSM_Bfs_Visit(gofsm, &bfs, j)){
+						gofsm->stats.expanded = (uint8_t)bfs.tail;
+						return gofsm->transitions[j];
+					}
+				}
+			}
+		}
+	}
+	gofsm->stats.expanded = (uint8_t)bfs.tail;
+	if(next_hop==NULL || bfs.current>=gofsm->nodes_capacity || next_hop[bfs.current]==GOFSM_NEXT_HOP_NONE)
+		return NULL;
+	return gofsm->transitions[next_hop[bfs.current]];
+}
+
+static GOFSM_Transition_t* GOFSM_SearchTable(GOFSM_t* gofsm){
+	uint8_t* next_hop = GOFSM_EXT_NEXT_HOP(gofsm);
+	if(!gofsm->is_table_valid){
+		memset(next_hop, GOFSM_NEXT_HOP_NONE, gofsm->nodes_capacity);
+		gofsm->is_table_valid = 1;
+		return GOFSM_SearchBitset(gofsm, gofsm->target_node_index, 1, next_hop);
+	}
+	if(gofsm->current_node_index>=gofsm->nodes_capacity || next_hop[gofsm->current_node_index]==GOFSM_NEXT_HOP_NONE)
+		return NULL;
+	GOFSM_Transition_t* transition = gofsm->transitions[next_hop[gofsm->current_node_index]];
+	// общий переход заблокирован через другой автомат: таблица строится заново
+	if(transition->state!=GOFSM_Transition_State_Available){
+		memset(next_hop, GOFSM_NEXT_HOP_NONE, gofsm->nodes_capacity);
+		return GOFSM_SearchBitset(gofsm, gofsm->target_node_index, 1, next_hop);
+	}
+	return transition;
+}
+
+// Все индексы нод меньше nodes_capacity (можно адресовать таблицы по ноде)
+static uint8_t GOFSM_IsCompact(GOFSM_t* gofsm){
+	for(uint8_t j=0; j<gofsm->transitions_count; j++){
+		GOFSM_Transition_t* transition = gofsm->transitions[j];
+		if((transition->source_node_index>=gofsm->nodes_capacity && !transition->is_any)
+			|| transition->destination_node_index>=gofsm->nodes_capacity)
+			return 0;
+	}
+	return 1;
+}
+
+static GOFSM_Plan_Entry_t* GOFSM_PlanCache_Find(GOFSM_Plan_Cache_t* cache, GOFSM_Node_Index_t target){
+	for(uint8_t i=0; i<cache->entries_count; i++)
+		if(cache->entries[i].target==target)
+			return cache->entries+i;
+	return NULL;
+}
+
+static void GOFSM_PlanCache_Invalidate(GOFSM_t* gofsm){
+	GOFSM_Plan_Cache_t* cache = gofsm->plan_cache;
+	if(cache==NULL) return;
+	for(uint8_t i=0; i<cache->entries_count; i++)
+		cache->entries[i].is_valid = 0;
+}
+
+// Учёт запроса цели: счётчик частоты для имеющейся записи,
+// иначе вытеснение наименее запрашиваемой незакреплённой записи
+static void GOFSM_PlanCache_Touch(GOFSM_Plan_Cache_t* cache, GOFSM_Node_Index_t target){
+	GOFSM_Plan_Entry_t* entry = GOFSM_PlanCache_Find(cache, target);
+	if(entry!=NULL){
+		if(entry->hits==UINT8_MAX){
+			// старение: сохраняем соотношение частот
+			for(uint8_t i=0; i<cache->entries_count; i++)
+				cache->entries[i].hits >>= 1;
+		}
+		entry->hits++;
+		return;
+	}
+	if(cache->entries_count<cache->entries_capacity){
+		entry = cache->entries+cache->entries_count;
+		cache->entries_count++;
+	}else{
+		for(uint8_t i=0; i<cache->entries_count; i++){
+			GOFSM_Plan_Entry_t* candidate = cache->entries+i;
+			if(candidate->is_pinned) continue;
+			if(entry==NULL || candidate->hits<entry->hits)
+				entry = candidate;
+		}
+		if(entry==NULL) return;
+	}
+	entry->target = target;
+	entry->hits = 1;
+	entry->is_pinned = 0;
+	entry->is_valid = 0;
+}
+
+// Возвращает 1, если для цели есть готовая таблица (в т.ч. с результатом "недостижимо")
+static uint8_t GOFSM_PlanCache_Lookup(GOFSM_t* gofsm, GOFSM_Transition_t** transition){
+	GOFSM_Plan_Cache_t* cache = gofsm->plan_cache;
+	GOFSM_Node_Index_t current = gofsm->current_node_index;
+	if(current>=gofsm->nodes_capacity) return 0;
+	GOFSM_Plan_Entry_t* entry = GOFSM_PlanCache_Find(cache, gofsm->target_node_index);
+	if(entry==NULL || !entry->is_valid) return 0;
+	uint8_t j = cache->next_hops[(entry-cache->entries)*cache->nodes_capacity+current];
+	*transition = j==GOFSM_NEXT_HOP_NONE ? NULL : gofsm->transitions[j];
+	// общий переход заблокирован через другой автомат: промах, поиск по живому графу
+	if(*transition!=NULL && (*transition)->state!=GOFSM_Transition_State_Available) return 0;
+	return 1;
+}
+
+// Один полный BFS за тик простоя: досчитать следующую недостающую таблицу
+static void GOFSM_PlanCache_Speculate(GOFSM_t* gofsm){
+	GOFSM_Plan_Cache_t* cache = gofsm->plan_cache;
+	for(uint8_t n=0; n<cache->entries_count; n++){
+		uint8_t i = (cache->cursor+n) % cache->entries_count;
+		GOFSM_Plan_Entry_t* entry = cache->entries+i;
+		if(entry->is_valid || entry->target>=gofsm->nodes_capacity) continue;
+		if(!GOFSM_IsCompact(gofsm)) return;
+
+		uint8_t use_index = 0;
+		if(gofsm->alg_ext_buffer!=NULL && gofsm->is_index_valid && !gofsm->is_graph_restructured)
+			use_index = 1;
+		uint8_t* next_hop = cache->next_hops+i*cache->nodes_capacity;
+		memset(next_hop, GOFSM_NEXT_HOP_NONE, cache->nodes_capacity);
+		GOFSM_SearchBitset(gofsm, entry->target, use_index, next_hop);
+		entry->is_valid = 1;
+		cache->cursor = i+1;
+		return;
+	}
+}
+
+// Выбор стратегии для Auto по окну последних GOFSM_PLANNER_AUTO_PERIOD перепланирований
+static GOFSM_Planner_t GOFSM_Planner_Evaluate(GOFSM_t* gofsm){
+	uint16_t edges = gofsm->transitions_count;
+	uint16_t nodes = gofsm->nodes_capacity;
+	if(edges<=GOFSM_PLANNER_SCAN_LIMIT)
+		return GOFSM_Planner_Scan;
+	if(gofsm->alg_ext_buffer==NULL)
+		return GOFSM_Planner_Bitset;
+	// таблица окупается, если между сменами цели/графа делается несколько шагов
+	uint16_t changes = gofsm->auto_retargets + gofsm->auto_reconfigures;
+	if(gofsm->auto_replans>=2*changes)
+		return GOFSM_Planner_Table;
+	// плотный граф: списки предшественников длинные, индекс почти не сокращает перебор
+	if((uint32_t)edges*4>=(uint32_t)nodes*nodes)
+		return GOFSM_Planner_Bitset;
+	return GOFSM_Planner_Index;
+}
+
+static GOFSM_Transition_t* GOFSM_Plan(GOFSM_t* gofsm){
+	if(gofsm->planner==GOFSM_Planner_Auto){
+		gofsm->auto_replans++;
+		gofsm->auto_retargets += gofsm->is_target_change;
+		gofsm->auto_reconfigures += gofsm->is_graph_reconfigured;
+		if(gofsm->auto_replans>=GOFSM_PLANNER_AUTO_PERIOD){
+			gofsm->planner_active = GOFSM_Planner_Evaluate(gofsm);
+			gofsm->is_table_valid = 0;
+			gofsm->auto_replans = 0;
+			gofsm->auto_retargets = 0;
+			gofsm->auto_reconfigures = 0;
+		}
+	}
+	if(gofsm->is_target_change || gofsm->is_graph_reconfigured)
+		gofsm->is_table_valid = 0;
+	gofsm->stats.expanded = 0;
+
+	if(gofsm->alg_ext_buffer!=NULL && !gofsm->is_soa_valid)
+		GOFSM_BuildSoa(gofsm);
+
+	GOFSM_Transition_t* cached;
+	if(gofsm->plan_cache!=NULL && GOFSM_PlanCache_Lookup(gofsm, &cached))
+		return cached;
+
+	GOFSM_Planner_t planner = gofsm->planner_active;
+	if(planner==GOFSM_Planner_Index || planner==GOFSM_Planner_Table){
+		if(gofsm->alg_ext_buffer==NULL
+			|| gofsm->target_node_index>=gofsm->nodes_capacity
+			|| gofsm->current_node_index>=gofsm->nodes_capacity)
+			planner = GOFSM_Planner_Bitset;
+	}
+	if(planner==GOFSM_Planner_Index || planner==GOFSM_Planner_Table){
+		if(gofsm->is_graph_restructured){
+			gofsm->is_index_valid = GOFSM_BuildIndex(gofsm);
+			gofsm->is_graph_restructured = 0;
+		}
+		if(!gofsm->is_index_valid)
+			planner = GOFSM_Planner_Bitset;
+	}
+
+	switch(planner){
+	case GOFSM_Planner_Bitset: return GOFSM_SearchBitset(gofsm, gofsm->target_node_index, 0, NULL);
+	case GOFSM_Planner_Index:  return GOFSM_SearchBitset(gofsm, gofsm->target_node_index, 1, NULL);
+	case GOFSM_Planner_Table:  return GOFSM_SearchTable(gofsm);
+	default:                   return GOFSM_SearchNextStep(gofsm);
+	}
+}
+
 void GOFSM_Init(GOFSM_t* gofsm, uint8_t transitions_capacity, uint8_t nodes_capacity){
 	gofsm->is_dyn = 1;
 
@@ -63,6 +598,8 @@ void GOFSM_Init(GOFSM_t* gofsm, uint8_t transitions_capacity, uint8_t nodes_capa
 
 	gofsm->transitions = (GOFSM_Transition_t**)malloc(transitions_capacity * sizeof(GOFSM_Transition_t*));
 	gofsm->alg_nodes_buffer = (GOFSM_Node_Index_t*)malloc(nodes_capacity * sizeof(GOFSM_Node_Index_t));
+	// расширенный буфер выделяет GOFSM_SetPlanner, если выбранной стратегии он нужен
+	gofsm->alg_ext_buffer = NULL;
 
 	GOFSM_InitStatic(gofsm);
 }
@@ -70,6 +607,8 @@ void GOFSM_Deinit(GOFSM_t* gofsm){
 	if(!gofsm->is_dyn) return;
 	free(gofsm->transitions);
 	free(gofsm->alg_nodes_buffer);
+	free(gofsm->alg_ext_buffer);
+	gofsm->alg_ext_buffer = NULL;
 }
 void GOFSM_InitStatic(GOFSM_t* gofsm){
 	GOFSM_ASSERT(gofsm!=NULL);
@@ -83,64 +622,465 @@ void GOFSM_InitStatic(GOFSM_t* gofsm){
 	gofsm->is_target_change = 1;
 	gofsm->is_transition_failure = 0;
 	gofsm->is_graph_reconfigured = 1;
+	gofsm->is_graph_restructured = 1;
+	gofsm->is_index_valid = 0;
+	gofsm->is_table_valid = 0;
+	gofsm->is_soa_valid = 0;
+	gofsm->plan_cache = NULL;
+	gofsm->events = NULL;
+	gofsm->graph_owner = NULL;
+	gofsm->graph_epoch = 0;
+	gofsm->graph_epoch_seen = 0;
+	gofsm->refs = 0;
+	gofsm->is_dispatched = 0;
+	gofsm->planner = GOFSM_Planner_Scan;
+	gofsm->planner_active = GOFSM_Planner_Scan;
+	gofsm->auto_replans = 0;
+	gofsm->auto_retargets = 0;
+	gofsm->auto_reconfigures = 0;
+	gofsm->replan_window = 0;
+	gofsm->replan_limit = 0;
+	gofsm->replan_window_ticks = 0;
+	gofsm->replan_window_count = 0;
+	memset(&gofsm->stats, 0, sizeof(gofsm->stats));
+	gofsm->arrival_callback = NULL;
+	gofsm->arrival_context = NULL;
+	gofsm->is_arrival_pending = 0;
+#ifdef GOFSM_KERNEL_DISPATCH
+	GOFSM_Kernel_Resolve();
+#endif
 }
 
 
-void GOFSM_Transition_Init(GOFSM_Transition_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function){
-	GOFSM_ASSERT(transition!=NULL);
+// Сброс всего, что выведено из графа: SoA, индекс, таблицы, кеш планов
+static void GOFSM_GraphChanged(GOFSM_t* gofsm, uint8_t is_restructured){
+	GOFSM_t* root = gofsm->graph_owner!=NULL ? gofsm->graph_owner : gofsm;
+	root->graph_epoch++;
+	gofsm->graph_epoch_seen = root->graph_epoch;
+	gofsm->is_graph_reconfigured = 1;
+	if(is_restructured){
+		gofsm->is_graph_restructured = 1;
+		gofsm->is_soa_valid = 0;
+	}
+	gofsm->stats.reconfigures++;
+	GOFSM_PROBE(reconfigure, gofsm, is_restructured);
+	GOFSM_PlanCache_Invalidate(gofsm);
+	// блокировка не меняет таблицу событий: состояние перехода проверяется при разборе события
+	if(is_restructured && gofsm->events!=NULL)
+		gofsm->events->is_valid = 0;
+}
+
+static void GOFSM_Transition_Setup(GOFSM_Transition_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function, uint8_t is_any){
 	transition->source_node_index = source_node_index;
 	transition->destination_node_index = destination_node_index;
 	transition->function = function;
 	transition->state = GOFSM_Transition_State_Available;
+	transition->event = GOFSM_EVENT_NONE;
+	transition->is_any = is_any;
+}
+void GOFSM_Transition_Init(GOFSM_Transition_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function){
+	GOFSM_ASSERT(transition!=NULL);
+	// источник "любая нода" есть только у GOFSM_Transition_Any_t
+	GOFSM_ASSERT(source_node_index!=GOFSM_NODE_ANY);
+	GOFSM_Transition_Setup(transition, source_node_index, destination_node_index, function, 0);
+}
+void GOFSM_Transition_SetEvent(GOFSM_Transition_t* transition, GOFSM_Event_t event){
+	GOFSM_ASSERT(transition!=NULL);
+	transition->event = event;
+}
+void GOFSM_Transition_InitAny(GOFSM_Transition_Any_t* transition, const uint8_t* source_set, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function){
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_Transition_Setup(&transition->transition, GOFSM_NODE_ANY, destination_node_index, function, 1);
+	transition->source_set = source_set;
 }
 void GOFSM_Transition_SetState(GOFSM_t* gofsm, GOFSM_Transition_t* transition, GOFSM_Transition_State_t state){
 	GOFSM_ASSERT(transition!=NULL);
 	transition->state = state;
+	GOFSM_GraphChanged(gofsm, 0);
+}
+
+// Граф изменил другой участник общего графа: состав мог смениться у владельца, производное сбрасывается.
+// Кеш планов и таблица событий общие, их сбросил изменивший
+static void GOFSM_GraphSync(GOFSM_t* gofsm, const GOFSM_t* root){
+	gofsm->transitions_count = root->transitions_count;
+	gofsm->graph_epoch_seen = root->graph_epoch;
 	gofsm->is_graph_reconfigured = 1;
+	gofsm->is_graph_restructured = 1;
+	gofsm->is_soa_valid = 0;
+}
+
+// Состав общего массива мог измениться после последнего тика клона
+static void GOFSM_GraphSyncShared(GOFSM_t* gofsm){
+	const GOFSM_t* root = gofsm->graph_owner;
+	if(root!=NULL && root->graph_epoch!=gofsm->graph_epoch_seen)
+		GOFSM_GraphSync(gofsm, root);
+}
+
+// Расширенный буфер нужен всем стратегиям, кроме Scan. Динамический автомат выделяет его
+// при первом выборе такой стратегии, поэтому автомат на Scan обходится исходным объёмом памяти
+static void GOFSM_AllocateExt(GOFSM_t* gofsm){
+	if(!gofsm->is_dyn || gofsm->alg_ext_buffer!=NULL || gofsm->planner==GOFSM_Planner_Scan)
+		return;
+	gofsm->alg_ext_buffer = (uint8_t*)malloc(GOFSM_ALG_EXT_SIZE(gofsm->transitions_capacity, gofsm->nodes_capacity));
+	gofsm->is_soa_valid = 0;
+	gofsm->is_index_valid = 0;
+	gofsm->is_graph_restructured = 1;
+}
+
+// Копирование при записи: клон получает свой массив переходов и буферы
+static void GOFSM_Detach(GOFSM_t* gofsm){
+	GOFSM_GraphSyncShared(gofsm);
+	GOFSM_Transition_t** transitions = (GOFSM_Transition_t**)malloc(gofsm->transitions_capacity * sizeof(GOFSM_Transition_t*));
+	memcpy(transitions, gofsm->transitions, gofsm->transitions_count * sizeof(GOFSM_Transition_t*));
+	gofsm->transitions = transitions;
+	gofsm->alg_nodes_buffer = (GOFSM_Node_Index_t*)malloc(gofsm->nodes_capacity * sizeof(GOFSM_Node_Index_t));
+	gofsm->alg_ext_buffer = NULL;
+	gofsm->graph_owner->refs--;
+	gofsm->graph_owner = NULL;
+	gofsm->graph_epoch = 0;
+	gofsm->graph_epoch_seen = 0;
+	gofsm->plan_cache = NULL;
+	gofsm->events = NULL;
+	gofsm->is_index_valid = 0;
+	gofsm->is_table_valid = 0;
+	gofsm->is_dyn = 1;
+	GOFSM_AllocateExt(gofsm);
+}
+
+void GOFSM_Clone(GOFSM_t* clone, GOFSM_t* source){
+	GOFSM_ASSERT(clone!=NULL);
+	GOFSM_ASSERT(source!=NULL);
+	memcpy(clone, source, sizeof(*clone));
+	clone->graph_owner = source->graph_owner!=NULL ? source->graph_owner : source;
+	clone->graph_owner->refs++;
+	clone->refs = 0;
+	// таблица следующих шагов зависит от цели, поэтому расширенный буфер не делится
+	clone->alg_ext_buffer = NULL;
+	clone->is_soa_valid = 0;
+	clone->is_index_valid = 0;
+	clone->is_table_valid = 0;
+	clone->arrival_callback = NULL;
+	clone->arrival_context = NULL;
+	clone->is_arrival_pending = 0;
+	memset(&clone->stats, 0, sizeof(clone->stats));
+	clone->is_dyn = 0;
 }
 
 GOFSM_Error_t GOFSM_AddTransition(GOFSM_t* gofsm, GOFSM_Transition_t* transition){
 	GOFSM_ASSERT(gofsm!=NULL);
 	GOFSM_ASSERT(transition!=NULL);
+	if(gofsm->graph_owner!=NULL)
+		GOFSM_Detach(gofsm);
 	if(gofsm->transitions_count == gofsm->transitions_capacity)
 		return GOFSM_Error_OwerstackTransitions;
 
 	gofsm->transitions[gofsm->transitions_count] = transition;
 	gofsm->transitions_count++;
-	gofsm->is_graph_reconfigured = 1;
+	GOFSM_GraphChanged(gofsm, 1);
 	return GOFSM_Error_No;
 }
 GOFSM_Error_t GOFSM_RemoveTransition(GOFSM_t* gofsm, GOFSM_Transition_t* transition){
 	GOFSM_ASSERT(gofsm!=NULL);
 	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_GraphSyncShared(gofsm);
     for(uint32_t i=0; i<gofsm->transitions_count; i++)
         if(gofsm->transitions[i]==transition) {
+        	if(gofsm->graph_owner!=NULL)
+        		GOFSM_Detach(gofsm);
         	uint32_t remaining = gofsm->transitions_count - i - 1;
         	memmove(gofsm->transitions+i, gofsm->transitions+i+1, remaining * sizeof(GOFSM_Transition_t*));
         	gofsm->transitions_count--;
+        	GOFSM_GraphChanged(gofsm, 1);
             return GOFSM_Error_No;
         }
     return GOFSM_Error_NotRegisteredTransition;
 }
 
+void GOFSM_Reconfigure(GOFSM_t* gofsm){
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_GraphChanged(gofsm, 1);
+}
+
 void GOFSM_SetCurrent(GOFSM_t* gofsm, GOFSM_Node_Index_t node_index){
 	GOFSM_ASSERT(gofsm!=NULL);
 	gofsm->current_node_index = node_index;
 	gofsm->is_target_change = 1;
 }
+static void GOFSM_Arrival_Notify(GOFSM_t* gofsm, GOFSM_Arrival_t arrival){
+	if(!gofsm->is_arrival_pending) return;
+	gofsm->is_arrival_pending = 0;
+	gofsm->arrival_callback(gofsm, gofsm->target_node_index, arrival, gofsm->arrival_context);
+}
+// Новая цель: прежняя ожидаемая цель отменяется
+static void GOFSM_Arrival_Arm(GOFSM_t* gofsm, GOFSM_Node_Index_t node_index){
+	if(gofsm->target_node_index!=node_index)
+		GOFSM_Arrival_Notify(gofsm, GOFSM_Arrival_Cancelled);
+	gofsm->is_arrival_pending = gofsm->arrival_callback!=NULL;
+}
+
+void GOFSM_SetArrivalCallback(GOFSM_t* gofsm, GOFSM_Arrival_Callback_t callback, void* context){
+	GOFSM_ASSERT(gofsm!=NULL);
+	gofsm->arrival_callback = callback;
+	gofsm->arrival_context = context;
+	gofsm->is_arrival_pending = 0;
+}
+
+void GOFSM_Abort(GOFSM_t* gofsm, GOFSM_Node_Index_t fallback_node_index){
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_Node_Index_t target_node_index = gofsm->target_node_index;
+	GOFSM_Arrival_Notify(gofsm, GOFSM_Arrival_Expired);
+	// обработчик мог сам назначить новую цель: запасная её не перетирает
+	if(gofsm->target_node_index==target_node_index)
+		GOFSM_SetTarget(gofsm, fallback_node_index);
+}
+
+void GOFSM_Resume(GOFSM_t* gofsm, GOFSM_Node_Index_t current_node_index, GOFSM_Node_Index_t target_node_index, GOFSM_Transition_t* transition_current){
+	GOFSM_ASSERT(gofsm!=NULL);
+	gofsm->current_node_index = current_node_index;
+	gofsm->target_node_index = target_node_index;
+	gofsm->transition_current = transition_current;
+	// повтор выбранного перехода — та же ветка OnTick, что после Failure
+	gofsm->is_transition_failure = transition_current!=NULL;
+	gofsm->is_target_change = 0;
+	gofsm->is_graph_reconfigured = 0;
+	gofsm->is_dispatched = 0;
+	// достигнутая до сохранения цель повторно не объявляется
+	gofsm->is_arrival_pending = gofsm->arrival_callback!=NULL && current_node_index!=target_node_index;
+	gofsm->is_soa_valid = 0;
+	// таблица next-hop построена для прежней цели и прежнего графа
+	gofsm->is_table_valid = 0;
+	GOFSM_PlanCache_Invalidate(gofsm);
+}
+
 void GOFSM_SetTarget(GOFSM_t* gofsm, GOFSM_Node_Index_t node_index){
 	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_PROBE(target_change, gofsm, gofsm->target_node_index, node_index);
+	GOFSM_Arrival_Arm(gofsm, node_index);
 	gofsm->target_node_index = node_index;
 	gofsm->is_target_change = 1;
+	if(gofsm->plan_cache!=NULL)
+		GOFSM_PlanCache_Touch(gofsm->plan_cache, node_index);
 }
 
-void GOFSM_OnTick(GOFSM_t* gofsm){
+void GOFSM_SetPlanner(GOFSM_t* gofsm, GOFSM_Planner_t planner){
+	GOFSM_ASSERT(gofsm!=NULL);
+	gofsm->planner = planner;
+	GOFSM_AllocateExt(gofsm);
+	// Auto стартует с Bitset и переоценивает выбор после первого окна
+	gofsm->planner_active = planner==GOFSM_Planner_Auto ? GOFSM_Planner_Bitset : planner;
+	gofsm->auto_replans = 0;
+	gofsm->auto_retargets = 0;
+	gofsm->auto_reconfigures = 0;
+	gofsm->is_table_valid = 0;
+}
+
+void GOFSM_SetReplanLimit(GOFSM_t* gofsm, uint8_t window_ticks, uint8_t max_replans){
+	GOFSM_ASSERT(gofsm!=NULL);
+	gofsm->replan_window = window_ticks;
+	gofsm->replan_limit = max_replans;
+	gofsm->replan_window_ticks = 0;
+	gofsm->replan_window_count = 0;
+}
+
+// Перепланирование, вызванное только изменением графа, откладывается после исчерпания лимита окна
+static uint8_t GOFSM_IsReplanDeferred(GOFSM_t* gofsm){
+	// нулевой лимит откладывал бы перепланирование навсегда: автомат на заблокированном переходе вставал бы
+	if(gofsm->replan_window==0 || gofsm->replan_limit==0) return 0;
+	if(++gofsm->replan_window_ticks>=gofsm->replan_window){
+		gofsm->replan_window_ticks = 0;
+		gofsm->replan_window_count = 0;
+	}
+	if(gofsm->is_target_change || !gofsm->is_graph_reconfigured)
+		return 0;
+	if(!gofsm->is_transition_failure && gofsm->transition_current!=NULL)
+		return 0;
+	if(gofsm->replan_window_count<gofsm->replan_limit){
+		gofsm->replan_window_count++;
+		return 0;
+	}
+	return 1;
+}
+
+void GOFSM_PlanCache_InitStatic(GOFSM_Plan_Cache_t* cache){
+	GOFSM_ASSERT(cache!=NULL);
+	GOFSM_ASSERT(cache->entries!=NULL);
+	GOFSM_ASSERT(cache->next_hops!=NULL);
+	cache->entries_count = 0;
+	cache->cursor = 0;
+}
+void GOFSM_PlanCache_Init(GOFSM_Plan_Cache_t* cache, uint8_t entries_capacity, uint8_t nodes_capacity){
+	cache->is_dyn = 1;
+
+	cache->entries_capacity = entries_capacity;
+	cache->nodes_capacity = nodes_capacity;
+
+	cache->entries = (GOFSM_Plan_Entry_t*)malloc(entries_capacity * sizeof(GOFSM_Plan_Entry_t));
+	cache->next_hops = (uint8_t*)malloc(entries_capacity * nodes_capacity);
+
+	GOFSM_PlanCache_InitStatic(cache);
+}
+void GOFSM_PlanCache_Deinit(GOFSM_Plan_Cache_t* cache){
+	if(!cache->is_dyn) return;
+	free(cache->entries);
+	free(cache->next_hops);
+}
+GOFSM_Error_t GOFSM_PlanCache_Pin(GOFSM_Plan_Cache_t* cache, GOFSM_Node_Index_t target){
+	GOFSM_ASSERT(cache!=NULL);
+	GOFSM_Plan_Entry_t* entry = GOFSM_PlanCache_Find(cache, target);
+	if(entry==NULL){
+		if(cache->entries_count==cache->entries_capacity)
+			return GOFSM_Error_PlanCacheFull;
+		entry = cache->entries+cache->entries_count;
+		cache->entries_count++;
+		entry->target = target;
+		entry->hits = 0;
+		entry->is_valid = 0;
+	}
+	entry->is_pinned = 1;
+	return GOFSM_Error_No;
+}
+
+void GOFSM_SetPlanCache(GOFSM_t* gofsm, GOFSM_Plan_Cache_t* cache){
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_ASSERT(cache==NULL || cache->nodes_capacity==gofsm->nodes_capacity);
+	gofsm->plan_cache = cache;
+	GOFSM_PlanCache_Invalidate(gofsm);
+}
+
+// Явные переходы заполняют таблицу первыми, wildcard-переходы — только свободные ячейки
+static GOFSM_Error_t GOFSM_Events_Build(GOFSM_t* gofsm){
+	GOFSM_Events_t* events = gofsm->events;
+	memset(events->table, GOFSM_EVENTS_TRANSITION_NONE, events->nodes_capacity*events->events_count);
+	for(uint8_t pass=0; pass<2; pass++)
+		for(uint8_t j=0; j<gofsm->transitions_count; j++){
+			GOFSM_Transition_t* transition = gofsm->transitions[j];
+			if(transition->event>=events->events_count) continue;
+			uint8_t is_any = transition->is_any;
+			if(is_any!=pass) continue;
+			if(!is_any){
+				if(transition->source_node_index>=events->nodes_capacity)
+					return GOFSM_Error_OwerstackNodes;
+				uint8_t* cell = events->table+transition->source_node_index*events->events_count+transition->event;
+				if(*cell==GOFSM_EVENTS_TRANSITION_NONE)
+					*cell = j;
+				continue;
+			}
+			for(uint16_t n=0; n<events->nodes_capacity; n++){
+				uint8_t* cell = events->table+n*events->events_count+transition->event;
+				if(*cell==GOFSM_EVENTS_TRANSITION_NONE && GOFSM_Transition_IsSource(transition, n, events->nodes_capacity))
+					*cell = j;
+			}
+		}
+	events->is_valid = 1;
+	return GOFSM_Error_No;
+}
+
+void GOFSM_Events_InitStatic(GOFSM_Events_t* events){
+	GOFSM_ASSERT(events!=NULL);
+	GOFSM_ASSERT(events->table!=NULL);
+	events->is_valid = 0;
+}
+void GOFSM_Events_Init(GOFSM_Events_t* events, uint8_t events_count, uint8_t nodes_capacity){
+	events->is_dyn = 1;
+
+	events->events_count = events_count;
+	events->nodes_capacity = nodes_capacity;
+
+	events->table = (uint8_t*)malloc(events_count * nodes_capacity);
+
+	GOFSM_Events_InitStatic(events);
+}
+void GOFSM_Events_Deinit(GOFSM_Events_t* events){
+	if(!events->is_dyn) return;
+	free(events->table);
+}
+
+void GOFSM_SetEvents(GOFSM_t* gofsm, GOFSM_Events_t* events){
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_ASSERT(events==NULL || events->nodes_capacity==gofsm->nodes_capacity);
+	gofsm->events = events;
+	if(events!=NULL)
+		events->is_valid = 0;
+}
+
+GOFSM_Error_t GOFSM_Dispatch(GOFSM_t* gofsm, GOFSM_Event_t event){
 	GOFSM_ASSERT(gofsm!=NULL);
-	if(gofsm->current_node_index==gofsm->target_node_index){
+	GOFSM_ASSERT(gofsm->events!=NULL);
+	GOFSM_Events_t* events = gofsm->events;
+	if(event>=events->events_count || gofsm->current_node_index>=events->nodes_capacity)
+		return GOFSM_Error_UnhandledEvent;
+	// таблица общая с шаблоном: клон перестраивает и читает её по актуальному составу массива
+	GOFSM_GraphSyncShared(gofsm);
+	if(!events->is_valid){
+		GOFSM_Error_t error = GOFSM_Events_Build(gofsm);
+		if(error!=GOFSM_Error_No)
+			return error;
+	}
+	uint8_t j = events->table[gofsm->current_node_index*events->events_count+event];
+	if(j==GOFSM_EVENTS_TRANSITION_NONE)
+		return GOFSM_Error_UnhandledEvent;
+	GOFSM_Transition_t* transition = gofsm->transitions[j];
+	if(transition->state!=GOFSM_Transition_State_Available)
+		return GOFSM_Error_UnhandledEvent;
+
+	// цель совпадает с назначением, поэтому после перехода планировщик простаивает
+	GOFSM_PROBE(target_change, gofsm, gofsm->target_node_index, transition->destination_node_index);
+	GOFSM_Arrival_Arm(gofsm, transition->destination_node_index);
+	gofsm->target_node_index = transition->destination_node_index;
+	gofsm->transition_current = transition;
+	gofsm->is_transition_failure = 0;
+	gofsm->is_target_change = 0;
+	gofsm->is_dispatched = 1;
+	return GOFSM_Error_No;
+}
+
+// Переход, выбранный GOFSM_Dispatch, мог быть заблокирован или удалён до тика
+static uint8_t GOFSM_IsDispatchValid(const GOFSM_t* gofsm){
+	const GOFSM_Transition_t* transition = gofsm->transition_current;
+	if(transition->state!=GOFSM_Transition_State_Available)
+		return 0;
+	if(!gofsm->is_graph_reconfigured)
+		return 1;
+	for(uint8_t j=0; j<gofsm->transitions_count; j++)
+		if(gofsm->transitions[j]==transition)
+			return 1;
+	return 0;
+}
+
+static void GOFSM_Tick(GOFSM_t* gofsm){
+	const GOFSM_t* root = gofsm->graph_owner!=NULL ? gofsm->graph_owner : gofsm;
+	if(root->graph_epoch!=gofsm->graph_epoch_seen)
+		GOFSM_GraphSync(gofsm, root);
+	// переход, выбранный событием, выполняется без поиска, в том числе петля в текущую ноду
+	uint8_t is_dispatched = gofsm->is_dispatched;
+	gofsm->is_dispatched = 0;
+	if(is_dispatched && !GOFSM_IsDispatchValid(gofsm)){
+		// цель события остаётся, путь к ней ищет планировщик
+		is_dispatched = 0;
+		gofsm->transition_current = NULL;
+		gofsm->is_target_change = 1;
+	}
+	if(!is_dispatched && gofsm->current_node_index==gofsm->target_node_index){
+		// простой: такт тратится на подготовку планов для вероятных следующих целей
+		GOFSM_Arrival_Notify(gofsm, GOFSM_Arrival_Reached);
+		if(gofsm->plan_cache!=NULL)
+			GOFSM_PlanCache_Speculate(gofsm);
 		return;
 	}
-	if(!gofsm->is_transition_failure || gofsm->is_target_change || gofsm->is_graph_reconfigured){
-		gofsm->transition_current = GOFSM_SearchNextStep(gofsm);
+	uint8_t is_replan = !is_dispatched && (!gofsm->is_transition_failure || gofsm->is_target_change || gofsm->is_graph_reconfigured);
+	if(!is_dispatched && GOFSM_IsReplanDeferred(gofsm)){
+		is_replan = 0;
+		gofsm->stats.replans_deferred++;
+		if(gofsm->transition_current==NULL || gofsm->transition_current->state!=GOFSM_Transition_State_Available)
+			return;
+	}
+	if(is_replan){
+		gofsm->stats.replans++;
+		// причина: бит 0 — смена цели, бит 1 — изменение графа, 0 — следующий шаг после успеха
+		GOFSM_PROBE(plan_start, gofsm, gofsm->current_node_index, gofsm->target_node_index,
+			gofsm->is_target_change | (gofsm->is_graph_reconfigured<<1));
+		GOFSM_PROFILE(plan, gofsm->transition_current = GOFSM_Plan(gofsm));
+		GOFSM_PROBE(plan_end, gofsm, gofsm->transition_current, gofsm->stats.expanded);
 		GOFSM_ASSERT(gofsm->transition_current!=NULL);
 		gofsm->is_target_change = 0;
 		gofsm->is_graph_reconfigured = 0;
@@ -150,14 +1090,27 @@ void GOFSM_OnTick(GOFSM_t* gofsm){
 
 	if(transition==NULL){
 		gofsm->is_transition_failure = 0;
+		GOFSM_Arrival_Notify(gofsm, GOFSM_Arrival_Unreachable);
 		return;
 	}
+	GOFSM_PROBE(transition_invoke, gofsm, transition, transition->source_node_index, transition->destination_node_index);
+	gofsm->stats.invocations++;
 	if(transition->function!=NULL){
-		result = transition->function(transition);
+		GOFSM_PROFILE_FUNCTION(transition->function, result = transition->function(transition));
 	}
+	GOFSM_PROBE(transition_result, gofsm, transition, result);
 	gofsm->is_transition_failure = !result;
 
 	if(result==GOFSM_Transition_Result_Success){
 		gofsm->current_node_index = transition->destination_node_index;
+		if(gofsm->current_node_index==gofsm->target_node_index)
+			GOFSM_Arrival_Notify(gofsm, GOFSM_Arrival_Reached);
 	}
 }
+
+void GOFSM_OnTick(GOFSM_t* gofsm){
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_PROBE(tick_entry, gofsm, gofsm->current_node_index, gofsm->target_node_index);
+	GOFSM_PROFILE(tick, GOFSM_Tick(gofsm));
+	GOFSM_PROBE(tick_exit, gofsm, gofsm->current_node_index, gofsm->target_node_index);
+}
@@ -14,9 +14,23 @@
 #define GOFSM_ASSERT(expr) ((void)0)
 #endif
 
+// Гистограммы длительностей тика, поиска и функций переходов (gofsm_profile.h)
+//#define GOFSM_PROFILE_ENABLED
+
+// Статические точки трассировки USDT провайдера gofsm (скрипты bpftrace в scripts/) компилируются
+// всегда, когда доступен sys/sdt.h. Отключение:
+//#define GOFSM_USDT_DISABLED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Строго не предполагается использование на больших графах
 // По этому установлено жёсткое ограничение на 255 нод
 typedef uint8_t GOFSM_Node_Index_t;
+// Метка события перехода для реактивного режима (GOFSM_Dispatch)
+typedef uint8_t GOFSM_Event_t;
+#define GOFSM_EVENT_NONE 0xFF
 
 typedef enum{
 	GOFSM_Transition_Result_Failure = 0,
@@ -28,10 +42,45 @@ typedef enum{
 	GOFSM_Transition_State_Available = 1
 }GOFSM_Transition_State_t;
 
+// Стратегия поиска следующего шага
+typedef enum{
+	GOFSM_Planner_Scan = 0,   // исходный BFS, посещённые ищутся перебором. Для крошечных графов
+	GOFSM_Planner_Bitset = 1, // BFS с битовой картой посещённых. Для плотных графов
+	GOFSM_Planner_Index = 2,  // BFS по индексу предшественников (CSR). Для разреженных графов
+	GOFSM_Planner_Table = 3,  // таблица следующих шагов до текущей цели, шаг за O(1) до смены цели/графа
+	GOFSM_Planner_Auto = 4    // выбор по размеру, плотности графа и наблюдаемой частоте смены цели/графа
+}GOFSM_Planner_t;
+
+// Index и Table требуют alg_ext_buffer и индексов нод меньше nodes_capacity,
+// иначе используется Bitset
+#define GOFSM_PLANNER_AUTO_PERIOD 64      // число перепланирований между переоценкой стратегии
+#define GOFSM_PLANNER_SCAN_LIMIT 16       // до скольки переходов достаточно Scan
+#define GOFSM_NODES_BITMAP_SIZE 32        // битовая карта на все 256 индексов нод
+
+// Вариант векторного ядра поиска предшественников
+typedef enum{
+	GOFSM_Kernel_Scalar = 0,  // переносимый SWAR
+	GOFSM_Kernel_SSE2 = 1,
+	GOFSM_Kernel_AVX2 = 2,
+	GOFSM_Kernel_AVX512 = 3,
+	GOFSM_Kernel_NEON = 4
+}GOFSM_Kernel_t;
+
 typedef enum{
 	GOFSM_Error_No = 0,
 	GOFSM_Error_OwerstackTransitions = 1,
 	GOFSM_Error_NotRegisteredTransition = 2,
+	GOFSM_Error_NamesCollision = 3,
+	GOFSM_Error_UnknownName = 4,
+	GOFSM_Error_PlanCacheFull = 5,
+	GOFSM_Error_KernelUnsupported = 6,
+	GOFSM_Error_OwerstackNodes = 7,
+	GOFSM_Error_Unsupported = 8,
+	GOFSM_Error_UnhandledEvent = 9,
+	GOFSM_Error_OwerstackSlots = 10,
+	GOFSM_Error_OwerstackWaits = 11,
+	GOFSM_Error_ThreadStart = 12,
+	GOFSM_Error_IoSetup = 13,
 }GOFSM_Error_t;
 
 struct GOFSM_Transition_t;
@@ -42,9 +91,103 @@ struct __attribute__((packed)) GOFSM_Transition_t {
 	GOFSM_Node_Index_t destination_node_index;
 	GOFSM_Transition_Function_t function;
 	GOFSM_Transition_State_t state;
+	GOFSM_Event_t event;
+	uint8_t is_any;                   // создан GOFSM_Transition_InitAny: структура — GOFSM_Transition_Any_t
 };
 
+// Переход из любой ноды (или из нод множества). Индекс 255 зарезервирован под источник "любая нода",
+// такой переход создаётся только через GOFSM_Transition_InitAny, GOFSM_Transition_Init его не принимает
+#define GOFSM_NODE_ANY 0xFF
+
+typedef struct __attribute__((packed)){
+	GOFSM_Transition_t transition;
+	const uint8_t* source_set;   // битовая карта GOFSM_NODES_BITMAP_SIZE байт (бит i — нода i) или NULL — все ноды
+}GOFSM_Transition_Any_t;
+
+// Для wildcard-перехода "любая нода" — любая из 0..nodes_capacity-1
+static inline uint8_t GOFSM_Transition_IsSource(const GOFSM_Transition_t* transition, GOFSM_Node_Index_t node_index, uint16_t nodes_capacity){
+	if(!transition->is_any)
+		return transition->source_node_index==node_index;
+	if(node_index>=nodes_capacity)
+		return 0;
+	const uint8_t* source_set = ((const GOFSM_Transition_Any_t*)transition)->source_set;
+	return source_set==NULL || (source_set[node_index>>3] & (1u<<(node_index&7)));
+}
+
+// Кеш планов: таблицы следующих шагов для вероятных целей.
+// Таблицы досчитываются по одной за тик, пока автомат стоит в цели, и сбрасываются при изменении графа.
+// Закреплённые цели задаются явно, остальные записи занимают самые часто запрашиваемые цели.
+typedef struct __attribute__((packed)){
+	GOFSM_Node_Index_t target;
+	uint8_t hits;
+	uint8_t is_pinned;
+	uint8_t is_valid;
+}GOFSM_Plan_Entry_t;
+
+typedef struct __attribute__((packed)){
+	uint8_t entries_capacity;
+	uint8_t entries_count;
+	uint8_t nodes_capacity;
+	uint8_t cursor;
+	GOFSM_Plan_Entry_t* entries;
+	uint8_t* next_hops;         // entries_capacity x nodes_capacity индексов переходов
+	uint8_t is_dyn;
+}GOFSM_Plan_Cache_t;
+
+#define GOFSM_PLAN_CACHE_STATIC_ALLOCATE(STORAGE, name, ECOUNT, NCOUNT)      \
+	STORAGE GOFSM_Plan_Entry_t name##_entries[ECOUNT];                         \
+	STORAGE uint8_t name##_next_hops[(ECOUNT)*(NCOUNT)];                       \
+	STORAGE GOFSM_Plan_Cache_t name = {                                        \
+		.entries_capacity = (ECOUNT),                                          \
+		.nodes_capacity   = (NCOUNT),                                          \
+		.entries          = name##_entries,                                    \
+		.next_hops        = name##_next_hops                                   \
+	}
+
+// Итог движения к цели, заданной GOFSM_SetTarget или GOFSM_Dispatch
+typedef enum{
+	GOFSM_Arrival_Reached = 0,     // текущая нода совпала с целью
+	GOFSM_Arrival_Unreachable = 1, // планировщик не нашёл пути; цель остаётся, поиск повторяется на следующих тиках
+	GOFSM_Arrival_Cancelled = 2,   // цель сменилась до достижения
+	GOFSM_Arrival_Expired = 3      // цель снята по истечении срока (GOFSM_Abort)
+}GOFSM_Arrival_t;
+
+struct GOFSM_t;
+typedef void (*GOFSM_Arrival_Callback_t)(struct GOFSM_t* gofsm, GOFSM_Node_Index_t target, GOFSM_Arrival_t arrival, void* context);
+
+// Пустая ячейка таблицы событий: индексы переходов 0..254
+#define GOFSM_EVENTS_TRANSITION_NONE 0xFF
+
+// Таблица событий: индекс перехода для каждой пары (нода, событие),
+// GOFSM_EVENTS_TRANSITION_NONE — событие не обрабатывается.
+// Строится из меток переходов при первом событии после изменения состава графа
+typedef struct __attribute__((packed)){
+	uint8_t nodes_capacity;
+	uint8_t events_count;
+	uint8_t* table;             // nodes_capacity x events_count индексов переходов
+	uint8_t is_valid;
+	uint8_t is_dyn;
+}GOFSM_Events_t;
+
+#define GOFSM_EVENTS_STATIC_ALLOCATE(STORAGE, name, ECOUNT, NCOUNT)          \
+	STORAGE uint8_t name##_table[(ECOUNT)*(NCOUNT)];                           \
+	STORAGE GOFSM_Events_t name = {                                            \
+		.nodes_capacity = (NCOUNT),                                            \
+		.events_count   = (ECOUNT),                                            \
+		.table          = name##_table                                         \
+	}
+
+// Счётчики работы планировщика
 typedef struct __attribute__((packed)){
+	uint32_t replans;           // выполненные поиски следующего шага
+	uint32_t replans_deferred;  // тики, на которых перепланирование из-за изменения графа отложено
+	uint32_t reconfigures;      // изменения графа (SetState/Add/Remove)
+	uint32_t invocations;       // вызовы переходов; подряд идущие номера у одного перехода — он не сменялся
+	uint8_t kernel;             // GOFSM_Kernel_t, которым выполнялся поиск предшественников
+	uint8_t expanded;           // нод, поставленных в очередь последним поиском (0 — ответ из кеша или таблицы)
+}GOFSM_Stats_t;
+
+typedef struct __attribute__((packed)) GOFSM_t{
 	uint8_t nodes_capacity;
 	uint8_t transitions_count;
 	uint8_t transitions_capacity;
@@ -53,9 +196,34 @@ typedef struct __attribute__((packed)){
 	GOFSM_Node_Index_t current_node_index;
 	GOFSM_Node_Index_t target_node_index;
 	GOFSM_Node_Index_t* alg_nodes_buffer;
+	uint8_t* alg_ext_buffer;
+	GOFSM_Plan_Cache_t* plan_cache;
+	GOFSM_Events_t* events;
+	struct GOFSM_t* graph_owner;      // не NULL — массив переходов, кеш планов и таблица событий общие с шаблоном
+	uint32_t graph_epoch;             // у владельца графа: счётчик изменений, общий для всех клонов
+	uint32_t graph_epoch_seen;
+	uint32_t refs;                    // неотделённые клоны и слоты исполнителей, хранящие указатель на автомат
+	uint8_t planner;
+	uint8_t planner_active;
+	uint8_t auto_replans;
+	uint8_t auto_retargets;
+	uint8_t auto_reconfigures;
+	uint8_t replan_window;
+	uint8_t replan_limit;
+	uint8_t replan_window_ticks;
+	uint8_t replan_window_count;
+	GOFSM_Stats_t stats;
+	GOFSM_Arrival_Callback_t arrival_callback;
+	void* arrival_context;
+	uint8_t is_arrival_pending;
 	uint8_t is_target_change;
 	uint8_t is_transition_failure;
 	uint8_t is_graph_reconfigured;
+	uint8_t is_graph_restructured;
+	uint8_t is_dispatched;
+	uint8_t is_index_valid;
+	uint8_t is_table_valid;
+	uint8_t is_soa_valid;
 	uint8_t is_dyn;
 }GOFSM_t;
 
@@ -69,23 +237,122 @@ typedef struct __attribute__((packed)){
         .alg_nodes_buffer     = name##_alg_nodes_buffer         \
     }
 
+// Назначения переходов читаются векторно блоками по 64 байта
+#define GOFSM_SOA_CHUNK 64
+#define GOFSM_SOA_SIZE(TCOUNT) (((TCOUNT)+GOFSM_SOA_CHUNK-1)/GOFSM_SOA_CHUNK*GOFSM_SOA_CHUNK)
+
+// Размер alg_ext_buffer: таблица следующих шагов (N) + индекс предшественников (N+1 смещений, T переходов)
+// + массив назначений переходов
+#define GOFSM_ALG_EXT_SIZE(TCOUNT, NCOUNT) (2*(NCOUNT)+1+(TCOUNT)+GOFSM_SOA_SIZE(TCOUNT))
+
+// То же, что GOFSM_STATIC_ALLOCATE, но с буфером для стратегий Index и Table
+#define GOFSM_STATIC_ALLOCATE_EXT(STORAGE, name, TCOUNT, NCOUNT)                       \
+	STORAGE GOFSM_Transition_t* name##_transitions[TCOUNT];                            \
+	STORAGE GOFSM_Node_Index_t name##_alg_nodes_buffer[NCOUNT];                        \
+	STORAGE uint8_t name##_alg_ext_buffer[GOFSM_ALG_EXT_SIZE(TCOUNT, NCOUNT)];         \
+	STORAGE GOFSM_t name = {                                                           \
+		.nodes_capacity       = (NCOUNT),                                              \
+		.transitions_capacity = (TCOUNT),                                              \
+		.transitions          = name##_transitions,                                    \
+		.alg_nodes_buffer     = name##_alg_nodes_buffer,                               \
+		.alg_ext_buffer       = name##_alg_ext_buffer                                  \
+	}
+
 // Использовать строго для экземпляров созданных через GOFSM_STATIC_ALLOCATE()
 void GOFSM_InitStatic(GOFSM_t* gofsm);
 
-// Динамическая инициализация
+// Динамическая инициализация. Выделяются только transitions и alg_nodes_buffer, как для Scan;
+// alg_ext_buffer выделяет GOFSM_SetPlanner при выборе другой стратегии
 void GOFSM_Init(GOFSM_t* gofsm, uint8_t transitions_capacity, uint8_t nodes_capacity);
 void GOFSM_Deinit(GOFSM_t* gofsm);
 
 void GOFSM_Transition_Init(GOFSM_Transition_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function);
+// Регистрируется как обычный переход: GOFSM_AddTransition(gofsm, &any->transition).
+// Неявные рёбра строятся только из нод с индексом меньше nodes_capacity
+void GOFSM_Transition_InitAny(GOFSM_Transition_Any_t* transition, const uint8_t* source_set, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function);
+// Метка события (GOFSM_EVENT_NONE — переход только для планировщика).
+// После смены метки у зарегистрированного перехода вызвать GOFSM_Reconfigure
+void GOFSM_Transition_SetEvent(GOFSM_Transition_t* transition, GOFSM_Event_t event);
 void GOFSM_Transition_SetState(GOFSM_t* gofsm, GOFSM_Transition_t* transition, GOFSM_Transition_State_t state);
 
 GOFSM_Error_t GOFSM_AddTransition(GOFSM_t* gofsm, GOFSM_Transition_t* transition);
 GOFSM_Error_t GOFSM_RemoveTransition(GOFSM_t* gofsm, GOFSM_Transition_t* transition);
+// Вызывать после прямого изменения нод зарегистрированных переходов
+void GOFSM_Reconfigure(GOFSM_t* gofsm);
 
 void GOFSM_SetCurrent(GOFSM_t* gofsm, GOFSM_Node_Index_t node_index);
 void GOFSM_SetTarget(GOFSM_t* gofsm, GOFSM_Node_Index_t node_index);
 
+// У динамического автомата стратегия, отличная от Scan, выделяет alg_ext_buffer (GOFSM_ALG_EXT_SIZE байт)
+void GOFSM_SetPlanner(GOFSM_t* gofsm, GOFSM_Planner_t planner);
+
+// Не более max_replans перепланирований из-за изменения графа за window_ticks тиков
+// (window_ticks==0 или max_replans==0 — без ограничения).
+// Пока перепланирование отложено, выполняется прежний переход, если он ещё доступен.
+// Смена цели и шаг после успешного перехода перепланируются всегда
+void GOFSM_SetReplanLimit(GOFSM_t* gofsm, uint8_t window_ticks, uint8_t max_replans);
+
+// Ядро выбирается автоматически при первой инициализации (на x86 — по CPUID).
+// GOFSM_SetKernel принудительно задаёт вариант для всех экземпляров, например для замеров
+GOFSM_Kernel_t GOFSM_GetKernel(void);
+GOFSM_Error_t GOFSM_SetKernel(GOFSM_Kernel_t kernel);
+
+// Использовать строго для кешей созданных через GOFSM_PLAN_CACHE_STATIC_ALLOCATE()
+void GOFSM_PlanCache_InitStatic(GOFSM_Plan_Cache_t* cache);
+void GOFSM_PlanCache_Init(GOFSM_Plan_Cache_t* cache, uint8_t entries_capacity, uint8_t nodes_capacity);
+void GOFSM_PlanCache_Deinit(GOFSM_Plan_Cache_t* cache);
+// Закрепить цель: запись не вытесняется часто запрашиваемыми целями
+GOFSM_Error_t GOFSM_PlanCache_Pin(GOFSM_Plan_Cache_t* cache, GOFSM_Node_Index_t target);
+
+// Подключение кеша (NULL — отключить). nodes_capacity кеша и автомата должны совпадать
+void GOFSM_SetPlanCache(GOFSM_t* gofsm, GOFSM_Plan_Cache_t* cache);
+
+// Использовать строго для таблиц созданных через GOFSM_EVENTS_STATIC_ALLOCATE()
+void GOFSM_Events_InitStatic(GOFSM_Events_t* events);
+void GOFSM_Events_Init(GOFSM_Events_t* events, uint8_t events_count, uint8_t nodes_capacity);
+void GOFSM_Events_Deinit(GOFSM_Events_t* events);
+
+// Подключение таблицы событий (NULL — отключить). nodes_capacity таблицы и автомата должны совпадать
+void GOFSM_SetEvents(GOFSM_t* gofsm, GOFSM_Events_t* events);
+
+// Реактивный режим: событие выбирает переход из текущей ноды одним обращением к таблице.
+// Цель переносится в ноду назначения, переход выполняется на ближайшем тике без поиска.
+// При явном и wildcard-переходе с одним событием приоритет у явного, среди равных — у раньше добавленного.
+// GOFSM_Error_UnhandledEvent — для текущей ноды событие не размечено или переход заблокирован,
+// GOFSM_Error_OwerstackNodes — размеченный переход выходит за nodes_capacity
+GOFSM_Error_t GOFSM_Dispatch(GOFSM_t* gofsm, GOFSM_Event_t event);
+
+// Уведомление о завершении движения к цели вместо опроса current_node_index (NULL — отключить).
+// Вызывается ровно один раз на цель: из GOFSM_OnTick при достижении или неудаче поиска,
+// из GOFSM_SetTarget/GOFSM_Dispatch с Cancelled, если ожидаемая цель сменилась.
+// Из обработчика можно задать следующую цель, кроме случая Cancelled
+void GOFSM_SetArrivalCallback(GOFSM_t* gofsm, GOFSM_Arrival_Callback_t callback, void* context);
+
+// Снятие недостигнутой цели: ожидающий получает Expired, автомат переключается на запасную цель.
+// Если обработчик Expired сам сменил цель, запасная не назначается
+void GOFSM_Abort(GOFSM_t* gofsm, GOFSM_Node_Index_t fallback_node_index);
+
+// Клон за O(1) без выделения памяти: копируется состояние выполнения (текущая нода, цель, план),
+// граф, кеш планов и таблица событий остаются общими с source, буфер поиска — общим с ним же,
+// поэтому клоны одного шаблона тикаются из одного потока, а шаблон живёт дольше клонов.
+// Первое GOFSM_AddTransition/GOFSM_RemoveTransition у клона копирует массив переходов
+// и выделяет свои буферы (кеш планов и таблица событий при этом отключаются).
+// Переходы — общие объекты: GOFSM_Transition_SetState у любого из участников меняет граф всех,
+// остальные замечают изменение на следующем тике. Клону нужна своя блокировка —
+// заменить переход своим через Remove/Add. До отделения клон ищет без alg_ext_buffer (Scan/Bitset)
+// и учитывается в refs шаблона: освобождения клона нет, поэтому неотделённый клон держит шаблон навсегда
+void GOFSM_Clone(GOFSM_t* clone, GOFSM_t* source);
+
+// Восстановление сохранённого состояния без перепланирования: следующий GOFSM_OnTick продолжает
+// transition_current (NULL — в цели или пути нет). Состояния переходов выставляются до вызова
+// через GOFSM_Transition_SetState, чтобы изменение заметили клоны; производные кеши автомата
+// (SoA, таблица next-hop, кеш планов) сбрасываются здесь
+void GOFSM_Resume(GOFSM_t* gofsm, GOFSM_Node_Index_t current_node_index, GOFSM_Node_Index_t target_node_index, GOFSM_Transition_t* transition_current);
+
 void GOFSM_OnTick(GOFSM_t* gofsm);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif
@@ -0,0 +1,143 @@
+#ifndef GOFSM_HPP
+#define GOFSM_HPP
+
+#include <GOFSM/gofsm.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+namespace gofsm {
+
+using Node = GOFSM_Node_Index_t;
+using Result = GOFSM_Transition_Result_t;
+using State = GOFSM_Transition_State_t;
+using Error = GOFSM_Error_t;
+using Planner = GOFSM_Planner_t;
+using Event = GOFSM_Event_t;
+
+// Переход с произвольным вызываемым объектом (обычно лямбдой) вместо указателя на функцию.
+// Объект хранится внутри перехода, вызов идёт через статический трамплин без std::function.
+// Функция возвращает Result или bool (true == Success).
+// Автомат хранит указатель на переход, поэтому переход не копируется и не перемещается.
+template<typename F>
+class Transition : public GOFSM_Transition_t {
+public:
+	Transition(Node source, Node destination, F function)
+		: function_(std::move(function)) {
+		GOFSM_Transition_Init(this, source, destination, &Transition::invoke);
+	}
+
+	Transition(const Transition&) = delete;
+	Transition& operator=(const Transition&) = delete;
+
+	Node source() const noexcept { return source_node_index; }
+	Node destination() const noexcept { return destination_node_index; }
+
+private:
+	static GOFSM_Transition_Result_t invoke(GOFSM_Transition_t* transition){
+		// указатель всегда указывает на базу объекта Transition, выравнивание объекта не нарушено
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+		Transition* self = static_cast<Transition*>(transition);
+#pragma GCC diagnostic pop
+		if constexpr (std::is_same_v<decltype(self->function_()), bool>)
+			return self->function_() ? GOFSM_Transition_Result_Success : GOFSM_Transition_Result_Failure;
+		else
+			return self->function_();
+	}
+
+	F function_;
+};
+
+// Автомат со встроенными буферами, аналог GOFSM_STATIC_ALLOCATE_EXT: ни одного обращения к куче.
+// При перемещении буферы копируются и указатели внутри GOFSM_t перенастраиваются на новый объект,
+// исходный автомат остаётся пустым (как после GOFSM_InitStatic). Клоны и слоты исполнителей хранят
+// адрес автомата, поэтому перемещать можно только автомат без них (refs==0), сам не являющийся клоном.
+// Проверка выполняется в любой сборке: нарушение вызывает std::abort(), а не оставляет висячие указатели. Extended=false убирает alg_ext_buffer (как GOFSM_STATIC_ALLOCATE):
+// Index и Table тогда сводятся к Bitset, зато объект меньше на GOFSM_ALG_EXT_SIZE байт.
+template<std::size_t MaxTransitions, std::size_t MaxNodes, bool Extended = true>
+class Machine {
+	static_assert(MaxTransitions>0 && MaxTransitions<=UINT8_MAX, "transitions capacity is limited to 255");
+	static_assert(MaxNodes>0 && MaxNodes<=UINT8_MAX, "nodes capacity is limited to 255");
+
+public:
+	Machine() noexcept {
+		bind();
+		GOFSM_InitStatic(&fsm_);
+	}
+
+	Machine(const Machine&) = delete;
+	Machine& operator=(const Machine&) = delete;
+
+	Machine(Machine&& other) noexcept {
+		take(other);
+	}
+	Machine& operator=(Machine&& other) noexcept {
+		if(this!=&other){
+			// перезаписываемый автомат тоже не должен быть ни на кого завязан
+			ensure_movable(fsm_);
+			take(other);
+		}
+		return *this;
+	}
+
+	Error add(GOFSM_Transition_t& transition) noexcept { return GOFSM_AddTransition(&fsm_, &transition); }
+	Error remove(GOFSM_Transition_t& transition) noexcept { return GOFSM_RemoveTransition(&fsm_, &transition); }
+	void setState(GOFSM_Transition_t& transition, State state) noexcept { GOFSM_Transition_SetState(&fsm_, &transition, state); }
+	void block(GOFSM_Transition_t& transition) noexcept { setState(transition, GOFSM_Transition_State_Blocked); }
+	void unblock(GOFSM_Transition_t& transition) noexcept { setState(transition, GOFSM_Transition_State_Available); }
+
+	void setCurrent(Node node) noexcept { GOFSM_SetCurrent(&fsm_, node); }
+	void setTarget(Node node) noexcept { GOFSM_SetTarget(&fsm_, node); }
+	void setPlanner(Planner planner) noexcept { GOFSM_SetPlanner(&fsm_, planner); }
+
+	void setEvents(GOFSM_Events_t* events) noexcept { GOFSM_SetEvents(&fsm_, events); }
+	Error dispatch(Event event) noexcept { return GOFSM_Dispatch(&fsm_, event); }
+
+	void tick() noexcept { GOFSM_OnTick(&fsm_); }
+
+	Node current() const noexcept { return fsm_.current_node_index; }
+	Node target() const noexcept { return fsm_.target_node_index; }
+	bool reached() const noexcept { return fsm_.current_node_index==fsm_.target_node_index; }
+
+	GOFSM_t* get() noexcept { return &fsm_; }
+	const GOFSM_t* get() const noexcept { return &fsm_; }
+
+private:
+	void bind() noexcept {
+		fsm_.nodes_capacity = MaxNodes;
+		fsm_.transitions_capacity = MaxTransitions;
+		fsm_.transitions = transitions_;
+		fsm_.alg_nodes_buffer = alg_nodes_buffer_;
+		fsm_.alg_ext_buffer = Extended ? alg_ext_buffer_ : nullptr;
+		fsm_.is_dyn = 0;
+	}
+
+	// GOFSM_ASSERT включён не во всех сборках, поэтому проверка своя и не отключается
+	static void ensure_movable(const GOFSM_t& fsm) noexcept {
+		if(fsm.refs!=0 || fsm.graph_owner!=nullptr)
+			std::abort();
+	}
+
+	void take(Machine& other) noexcept {
+		ensure_movable(other.fsm_);
+		fsm_ = other.fsm_;
+		for(std::size_t i=0; i<MaxTransitions; i++)
+			transitions_[i] = other.transitions_[i];
+		for(std::size_t i=0; i<sizeof(alg_ext_buffer_); i++)
+			alg_ext_buffer_[i] = other.alg_ext_buffer_[i];
+		bind();
+		GOFSM_InitStatic(&other.fsm_);
+	}
+
+	GOFSM_t fsm_{};
+	GOFSM_Transition_t* transitions_[MaxTransitions]{};
+	GOFSM_Node_Index_t alg_nodes_buffer_[MaxNodes]{};
+	uint8_t alg_ext_buffer_[Extended ? GOFSM_ALG_EXT_SIZE(MaxTransitions, MaxNodes) : 1]{};
+};
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE     // ftruncate(), fsync()
+#endif
+#include <GOFSM/gofsm_checkpoint.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(GOFSM_Checkpoint_Record_t)==48, "GOFSM_Checkpoint_Record_t layout");
+_Static_assert(sizeof(GOFSM_Checkpoint_Header_t)==16, "GOFSM_Checkpoint_Header_t layout");
+
+#define GOFSM_CHECKPOINT_NONE 0xFF
+
+uint32_t GOFSM_Fingerprint(const GOFSM_t* gofsm){
+	GOFSM_ASSERT(gofsm!=NULL);
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	hash = (hash ^ gofsm->transitions_count) * 16777619u;
+	for(uint8_t i=0; i<gofsm->transitions_count; i++){
+		const GOFSM_Transition_t* transition = gofsm->transitions[i];
+		hash = (hash ^ transition->source_node_index) * 16777619u;
+		hash = (hash ^ transition->destination_node_index) * 16777619u;
+		hash = (hash ^ transition->event) * 16777619u;
+	}
+	return hash;
+}
+
+static void GOFSM_Checkpoint_Fill(const GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Checkpoint_Record_t* record){
+	const GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	const GOFSM_t* gofsm = entry->gofsm;
+	memset(record, 0, sizeof(*record));
+	record->transition_current = GOFSM_CHECKPOINT_NONE;
+	if(gofsm==NULL) return;
+	record->fingerprint = GOFSM_Fingerprint(gofsm);
+	record->flags = GOFSM_CHECKPOINT_FLAG_USED
+		| (gofsm->is_target_change || gofsm->is_graph_reconfigured || gofsm->is_dispatched ? GOFSM_CHECKPOINT_FLAG_REPLAN : 0)
+		| (entry->is_parked ? GOFSM_CHECKPOINT_FLAG_PARKED : 0);
+	record->current_node_index = gofsm->current_node_index;
+	record->target_node_index = gofsm->target_node_index;
+	record->transitions_count = gofsm->transitions_count;
+	for(uint8_t i=0; i<gofsm->transitions_count; i++){
+		if(gofsm->transitions[i]==gofsm->transition_current)
+			record->transition_current = i;
+		if(gofsm->transitions[i]->state==GOFSM_Transition_State_Blocked)
+			record->blocked[i>>3] |= (uint8_t)(1u<<(i&7));
+	}
+	if(entry->is_deadline && entry->deadline_target==gofsm->target_node_index){
+		record->flags |= GOFSM_CHECKPOINT_FLAG_DEADLINE;
+		record->deadline_remaining = entry->deadline_tick-executor->now;
+		record->fallback_node_index = entry->fallback_node_index;
+	}
+}
+
+GOFSM_Error_t GOFSM_Checkpoint_Save(const GOFSM_Executor_t* executor, const char* path){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(path!=NULL);
+	char temporary[4096];
+	if(snprintf(temporary, sizeof(temporary), "%s.tmp", path)>=(int)sizeof(temporary))
+		return GOFSM_Error_IoSetup;
+	size_t size = sizeof(GOFSM_Checkpoint_Header_t)+executor->slots_used*sizeof(GOFSM_Checkpoint_Record_t);
+	int fd = open(temporary, O_CREAT | O_TRUNC | O_RDWR, 0644);
+	if(fd<0)
+		return GOFSM_Error_IoSetup;
+	void* memory = MAP_FAILED;
+	if(ftruncate(fd, (off_t)size)==0)
+		memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(memory==MAP_FAILED){
+		close(fd);
+		unlink(temporary);
+		return GOFSM_Error_IoSetup;
+	}
+	GOFSM_Checkpoint_Header_t* header = (GOFSM_Checkpoint_Header_t*)memory;
+	GOFSM_Checkpoint_Record_t* records = (GOFSM_Checkpoint_Record_t*)(header+1);
+	header->magic = GOFSM_CHECKPOINT_MAGIC;
+	header->version = GOFSM_CHECKPOINT_VERSION;
+	header->record_size = sizeof(GOFSM_Checkpoint_Record_t);
+	header->records_count = executor->slots_used;
+	for(GOFSM_Slot_t slot=0; slot<executor->slots_used; slot++)
+		GOFSM_Checkpoint_Fill(executor, slot, records+slot);
+	uint8_t is_written = msync(memory, size, MS_SYNC)==0;
+	munmap(memory, size);
+	is_written = is_written && fsync(fd)==0;
+	close(fd);
+	// прежняя точка остаётся целой, пока новая не записана полностью
+	if(!is_written || rename(temporary, path)!=0){
+		unlink(temporary);
+		return GOFSM_Error_IoSetup;
+	}
+	return GOFSM_Error_No;
+}
+
+static uint8_t GOFSM_Checkpoint_Apply(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, const GOFSM_Checkpoint_Record_t* record){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_t* gofsm = entry->gofsm;
+	if(gofsm==NULL || !(record->flags & GOFSM_CHECKPOINT_FLAG_USED)) return 0;
+	if(record->transitions_count!=gofsm->transitions_count || record->fingerprint!=GOFSM_Fingerprint(gofsm)) return 0;
+	// через SetState: эпоха графа сдвигается, и клоны с общими переходами перепланируют
+	for(uint8_t i=0; i<gofsm->transitions_count; i++){
+		GOFSM_Transition_State_t state = (record->blocked[i>>3] & (1u<<(i&7))) ? GOFSM_Transition_State_Blocked : GOFSM_Transition_State_Available;
+		if(gofsm->transitions[i]->state!=state)
+			GOFSM_Transition_SetState(gofsm, gofsm->transitions[i], state);
+	}
+	GOFSM_Transition_t* transition_current = record->transition_current<gofsm->transitions_count
+		? gofsm->transitions[record->transition_current] : NULL;
+	GOFSM_Resume(gofsm, record->current_node_index, record->target_node_index, transition_current);
+	if(record->flags & GOFSM_CHECKPOINT_FLAG_REPLAN)
+		GOFSM_SetTarget(gofsm, record->target_node_index);
+	entry->last_node_index = record->current_node_index;
+	// без пути автомат будят изменения графа и цели — такая парковка восстанавливается.
+	// Парковку на переходе будят барьер или завершение io_uring, которых после перезапуска нет:
+	// первый тик повторяет переход, и тот паркует слот заново с действующим источником пробуждения
+	entry->is_parked = (record->flags & GOFSM_CHECKPOINT_FLAG_PARKED)!=0 && transition_current==NULL;
+	GOFSM_Executor_SetDeadline(executor, slot,
+		(record->flags & GOFSM_CHECKPOINT_FLAG_DEADLINE) ? record->deadline_remaining : 0, record->fallback_node_index);
+	return 1;
+}
+
+GOFSM_Error_t GOFSM_Checkpoint_Restore(GOFSM_Executor_t* executor, const char* path, GOFSM_Slot_t* restored){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(path!=NULL);
+	if(restored!=NULL)
+		*restored = 0;
+	int fd = open(path, O_RDONLY);
+	if(fd<0)
+		return GOFSM_Error_IoSetup;
+	struct stat info;
+	void* memory = MAP_FAILED;
+	if(fstat(fd, &info)==0 && (size_t)info.st_size>=sizeof(GOFSM_Checkpoint_Header_t))
+		memory = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(memory==MAP_FAILED)
+		return GOFSM_Error_IoSetup;
+	size_t size = (size_t)info.st_size;
+	const GOFSM_Checkpoint_Header_t* header = (const GOFSM_Checkpoint_Header_t*)memory;
+	const GOFSM_Checkpoint_Record_t* records = (const GOFSM_Checkpoint_Record_t*)(header+1);
+	if(header->magic!=GOFSM_CHECKPOINT_MAGIC || header->version!=GOFSM_CHECKPOINT_VERSION
+		|| header->record_size!=sizeof(GOFSM_Checkpoint_Record_t)
+		|| size<sizeof(GOFSM_Checkpoint_Header_t)+(size_t)header->records_count*sizeof(GOFSM_Checkpoint_Record_t)){
+		munmap(memory, size);
+		return GOFSM_Error_Unsupported;
+	}
+	GOFSM_Slot_t count = 0;
+	GOFSM_Slot_t limit = header->records_count<executor->slots_used ? (GOFSM_Slot_t)header->records_count : executor->slots_used;
+	for(GOFSM_Slot_t slot=0; slot<limit; slot++)
+		count += GOFSM_Checkpoint_Apply(executor, slot, records+slot);
+	munmap(memory, size);
+	if(restored!=NULL)
+		*restored = count;
+	return GOFSM_Error_No;
+}
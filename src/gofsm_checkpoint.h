@@ -0,0 +1,58 @@
+#ifndef GOFSM_CHECKPOINT_H
+#define GOFSM_CHECKPOINT_H
+
+#include <GOFSM/gofsm_executor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Контрольная точка состояния автоматов исполнителя для быстрого перезапуска процесса.
+// Файл — заголовок и запись фиксированного размера на слот, читается прямо из отображения.
+// Графы не сохраняются: переходы содержат указатели на функции, поэтому после перезапуска граф
+// строится заново теми же вызовами. Отпечаток графа в записи защищает от восстановления в граф
+// другой формы. Восстановление не планирует заново: автомат продолжает сохранённый переход
+#define GOFSM_CHECKPOINT_MAGIC 0x4B43464Fu    // "OFCK"
+#define GOFSM_CHECKPOINT_VERSION 1
+
+#define GOFSM_CHECKPOINT_FLAG_USED     0x01
+#define GOFSM_CHECKPOINT_FLAG_REPLAN   0x02   // при сохранении ждал перепланирования
+#define GOFSM_CHECKPOINT_FLAG_PARKED   0x04   // восстанавливается только для автомата без пути к цели
+#define GOFSM_CHECKPOINT_FLAG_DEADLINE 0x08
+
+typedef struct{
+	uint32_t fingerprint;                 // GOFSM_Fingerprint() графа
+	uint32_t deadline_remaining;          // тиков до срока
+	uint8_t flags;                        // GOFSM_CHECKPOINT_FLAG_*
+	uint8_t current_node_index;
+	uint8_t target_node_index;
+	uint8_t transition_current;           // индекс в transitions, 0xFF — нет
+	uint8_t fallback_node_index;
+	uint8_t transitions_count;
+	uint8_t reserved[2];
+	uint8_t blocked[32];                  // бит i — переход i заблокирован
+}GOFSM_Checkpoint_Record_t;
+
+typedef struct{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t records_count;
+	uint32_t reserved;
+}GOFSM_Checkpoint_Header_t;
+
+// Отпечаток формы графа: порядок, концы и события переходов. Состояния переходов не входят
+uint32_t GOFSM_Fingerprint(const GOFSM_t* gofsm);
+
+// Запись во временный файл и атомарная замена path. GOFSM_Error_IoSetup — ошибка записи
+GOFSM_Error_t GOFSM_Checkpoint_Save(const GOFSM_Executor_t* executor, const char* path);
+// Автоматы должны быть добавлены в исполнитель в тех же слотах, графы построены.
+// Слоты с другим отпечатком или без автомата пропускаются; restored — число восстановленных (может быть NULL).
+// GOFSM_Error_IoSetup — файла нет, GOFSM_Error_Unsupported — другая версия раскладки
+GOFSM_Error_t GOFSM_Checkpoint_Restore(GOFSM_Executor_t* executor, const char* path, GOFSM_Slot_t* restored);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
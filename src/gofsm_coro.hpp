@@ -0,0 +1,267 @@
+#ifndef GOFSM_CORO_HPP
+#define GOFSM_CORO_HPP
+
+#include <GOFSM/gofsm.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+
+namespace gofsm {
+
+using Arrival = GOFSM_Arrival_t;
+
+// Пул кадров корутин фиксированного размера: выделение и освобождение за O(1) без обращения к куче.
+// Перед кадром хранится заголовок с указателем на пул, поэтому освобождение не требует знать пул.
+class FramePoolBase {
+public:
+	FramePoolBase(const FramePoolBase&) = delete;
+	FramePoolBase& operator=(const FramePoolBase&) = delete;
+
+	// nullptr — кадр не помещается в блок или свободных блоков нет
+	void* allocate(std::size_t size) noexcept {
+		if(size+header_size>block_size_ || free_==nullptr)
+			return nullptr;
+		Block* block = free_;
+		free_ = block->next;
+		return frame(block);
+	}
+
+	std::size_t available() const noexcept {
+		std::size_t count = 0;
+		for(const Block* block=free_; block!=nullptr; block=block->next)
+			count++;
+		return count;
+	}
+
+	// Освобождение кадра, выделенного через пул или через кучу (пул в заголовке равен nullptr)
+	static void release(void* frame) noexcept {
+		Block* block = reinterpret_cast<Block*>(static_cast<unsigned char*>(frame)-header_size);
+		FramePoolBase* pool = block->pool;
+		if(pool==nullptr){
+			::operator delete(block);
+			return;
+		}
+		block->next = pool->free_;
+		pool->free_ = block;
+	}
+
+	// Пул, назначенный FrameScope. Свой у каждого потока: исполнители пула тикаются параллельно
+	static FramePoolBase*& current() noexcept {
+		thread_local FramePoolBase* pool = nullptr;
+		return pool;
+	}
+
+	static void* allocate_heap(std::size_t size) noexcept {
+		void* memory = ::operator new(size+header_size, std::nothrow);
+		if(memory==nullptr)
+			return nullptr;
+		Block* block = static_cast<Block*>(memory);
+		block->pool = nullptr;
+		return static_cast<unsigned char*>(memory)+header_size;
+	}
+
+protected:
+	FramePoolBase(unsigned char* storage, std::size_t block_size, std::size_t blocks) noexcept
+		: block_size_(block_size) {
+		for(std::size_t i=blocks; i>0; i--){
+			Block* block = reinterpret_cast<Block*>(storage+(i-1)*block_size);
+			block->next = free_;
+			free_ = block;
+		}
+	}
+
+	// заголовок выровнен как max_align_t, чтобы кадр сохранял выравнивание блока
+	union Block {
+		FramePoolBase* pool;    // выделенный блок
+		Block* next;            // свободный блок
+		alignas(std::max_align_t) unsigned char header[1];
+	};
+	static constexpr std::size_t header_size = sizeof(Block);
+
+private:
+	void* frame(Block* block) noexcept {
+		block->pool = this;
+		return reinterpret_cast<unsigned char*>(block)+header_size;
+	}
+
+	Block* free_ = nullptr;
+	std::size_t block_size_;
+};
+
+template<std::size_t FrameSize, std::size_t Frames>
+class FramePool : public FramePoolBase {
+	static constexpr std::size_t block_size =
+		(FrameSize+header_size+alignof(std::max_align_t)-1)/alignof(std::max_align_t)*alignof(std::max_align_t);
+
+public:
+	FramePool() noexcept : FramePoolBase(storage_, block_size, Frames) {}
+
+private:
+	alignas(std::max_align_t) unsigned char storage_[block_size*Frames];
+};
+
+// Пул для кадров корутин, вызванных в пределах области видимости объекта.
+// Вне области кадры берутся из кучи. Области вкладываются, прежний пул восстанавливается
+class FrameScope {
+public:
+	explicit FrameScope(FramePoolBase& pool) noexcept : previous_(FramePoolBase::current()) {
+		FramePoolBase::current() = &pool;
+	}
+	~FrameScope() { FramePoolBase::current() = previous_; }
+	FrameScope(const FrameScope&) = delete;
+	FrameScope& operator=(const FrameScope&) = delete;
+
+private:
+	FramePoolBase* previous_;
+};
+
+// Корутина последовательности. Стартует сразу при вызове, кадр освобождается деструктором Task.
+// Кадр берётся из пула текущей FrameScope, вне её — из кучи.
+// При нехватке памяти возвращается пустой Task (valid()==false), исключения не используются.
+class Task {
+public:
+	struct promise_type {
+		Task get_return_object() noexcept { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+
+		static void* operator new(std::size_t size) noexcept {
+			FramePoolBase* pool = FramePoolBase::current();
+			return pool!=nullptr ? pool->allocate(size) : FramePoolBase::allocate_heap(size);
+		}
+		static void operator delete(void* frame) noexcept {
+			FramePoolBase::release(frame);
+		}
+	};
+
+	Task() noexcept = default;
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+	Task(Task&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+	Task& operator=(Task&& other) noexcept {
+		if(this!=&other){
+			reset();
+			handle_ = other.handle_;
+			other.handle_ = nullptr;
+		}
+		return *this;
+	}
+	~Task() { reset(); }
+
+	bool valid() const noexcept { return static_cast<bool>(handle_); }
+	bool done() const noexcept { return !handle_ || handle_.done(); }
+
+	// Уничтожение кадра, в том числе приостановленной корутины
+	void reset() noexcept {
+		if(handle_)
+			handle_.destroy();
+		handle_ = nullptr;
+	}
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+	std::coroutine_handle<promise_type> handle_;
+};
+
+// Точка ожидания автомата: держит обработчик GOFSM_SetArrivalCallback и одну ожидающую корутину.
+// Корутина возобновляется прямо из обработчика, то есть внутри GOFSM_OnTick (или GOFSM_SetTarget при Cancelled).
+// Автомат хранит указатель на объект, поэтому он не копируется и не перемещается
+class Waiter {
+public:
+	explicit Waiter(GOFSM_t* fsm) noexcept : fsm_(fsm) {
+		GOFSM_SetArrivalCallback(fsm_, &Waiter::on_arrival, this);
+	}
+	~Waiter() {
+		GOFSM_SetArrivalCallback(fsm_, nullptr, nullptr);
+	}
+	Waiter(const Waiter&) = delete;
+	Waiter& operator=(const Waiter&) = delete;
+
+	class Awaiter {
+	public:
+		// кадр уничтожен во время ожидания (Task::reset): регистрация снимается
+		~Awaiter() {
+			if(handle_ && waiter_.handle_==handle_)
+				waiter_.handle_ = nullptr;
+		}
+		Awaiter(const Awaiter&) = delete;
+		Awaiter& operator=(const Awaiter&) = delete;
+
+		// в цели уже стоим: результат готов без приостановки
+		bool await_ready() noexcept {
+			if(waiter_.fsm_->current_node_index!=node_)
+				return false;
+			waiter_.cancel();
+			GOFSM_SetTarget(waiter_.fsm_, node_);
+			waiter_.arrival_ = GOFSM_Arrival_Reached;
+			return true;
+		}
+		void await_suspend(std::coroutine_handle<> handle) noexcept {
+			// прежняя ожидающая корутина получает Cancelled до регистрации новой, даже при той же цели
+			waiter_.cancel();
+			GOFSM_SetTarget(waiter_.fsm_, node_);
+			waiter_.handle_ = handle;
+			handle_ = handle;
+		}
+		Arrival await_resume() const noexcept { return waiter_.arrival_; }
+
+	private:
+		friend class Waiter;
+		Awaiter(Waiter& waiter, Node node) noexcept : waiter_(waiter), node_(node) {}
+
+		Waiter& waiter_;
+		Node node_;
+		std::coroutine_handle<> handle_;
+	};
+
+	// co_await reach(node) задаёт цель и приостанавливает корутину до уведомления о ней.
+	// После Cancelled не ожидать этот же автомат до выхода из обработчика
+	Awaiter reach(Node node) noexcept { return Awaiter(*this, node); }
+
+	bool waiting() const noexcept { return static_cast<bool>(handle_); }
+
+private:
+	void resume(Arrival arrival) {
+		std::coroutine_handle<> handle = handle_;
+		if(!handle)
+			return;
+		handle_ = nullptr;
+		arrival_ = arrival;
+		handle.resume();
+	}
+	void cancel() { resume(GOFSM_Arrival_Cancelled); }
+
+	static void on_arrival(GOFSM_t*, GOFSM_Node_Index_t, GOFSM_Arrival_t arrival, void* context) {
+		static_cast<Waiter*>(context)->resume(arrival);
+	}
+
+	GOFSM_t* fsm_;
+	std::coroutine_handle<> handle_;
+	Arrival arrival_ = GOFSM_Arrival_Reached;
+};
+
+// Machine с точкой ожидания: co_await machine.reach(node).
+// В отличие от Machine не перемещается — обработчик автомата ссылается на объект
+template<std::size_t MaxTransitions, std::size_t MaxNodes>
+class CoMachine : public Machine<MaxTransitions, MaxNodes> {
+public:
+	CoMachine() noexcept : waiter_(this->get()) {}
+	CoMachine(CoMachine&&) = delete;
+	CoMachine& operator=(CoMachine&&) = delete;
+
+	Waiter::Awaiter reach(Node node) noexcept { return waiter_.reach(node); }
+	bool waiting() const noexcept { return waiter_.waiting(); }
+
+private:
+	Waiter waiter_;
+};
+
+}
+
+#endif
@@ -0,0 +1,756 @@
+#include <GOFSM/gofsm_executor.h>
+
+#define GOFSM_WAIT_NONE 0xFFFF
+
+static void GOFSM_Executor_Unlink(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	if(!entry->is_deadline) return;
+	if(entry->deadline_prev!=GOFSM_SLOT_NONE)
+		executor->slots[entry->deadline_prev].deadline_next = entry->deadline_next;
+	else
+		executor->wheel[entry->deadline_tick & (executor->wheel_size-1)] = entry->deadline_next;
+	if(entry->deadline_next!=GOFSM_SLOT_NONE)
+		executor->slots[entry->deadline_next].deadline_prev = entry->deadline_prev;
+	entry->is_deadline = 0;
+}
+
+static void GOFSM_Executor_Link(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_Slot_t* head = executor->wheel+(entry->deadline_tick & (executor->wheel_size-1));
+	entry->deadline_prev = GOFSM_SLOT_NONE;
+	entry->deadline_next = *head;
+	if(*head!=GOFSM_SLOT_NONE)
+		executor->slots[*head].deadline_prev = slot;
+	*head = slot;
+	entry->is_deadline = 1;
+}
+
+static uint16_t GOFSM_Waits_Bucket(const GOFSM_Waits_t* waits, GOFSM_Slot_t on_slot, GOFSM_Node_Index_t on_node){
+	return (uint16_t)((((uint32_t)on_slot<<8 | on_node) * 0x9E3779B1u >> 16) % waits->waits_capacity);
+}
+
+static uint16_t GOFSM_Waits_TransitionBucket(const GOFSM_Waits_t* waits, const GOFSM_Transition_t* transition){
+	return (uint16_t)((uint32_t)(((uintptr_t)transition >> 2) * 0x9E3779B1u) % waits->waits_capacity);
+}
+
+// Исключение записи i из корзины bucket, prev — предыдущая запись корзины или GOFSM_WAIT_NONE.
+// В корзине по переходу предшественник ищется проходом по её короткой цепочке
+static void GOFSM_Waits_Release(GOFSM_Executor_t* executor, uint16_t bucket, uint16_t prev, uint16_t i){
+	GOFSM_Waits_t* waits = executor->waits;
+	GOFSM_Wait_t* wait = waits->waits+i;
+	if(prev==GOFSM_WAIT_NONE)
+		waits->buckets[bucket] = wait->next;
+	else
+		waits->waits[prev].next = wait->next;
+	uint16_t* link = waits->transition_buckets+GOFSM_Waits_TransitionBucket(waits, wait->transition);
+	if(*link==i)
+		*link = wait->transition_next;
+	else{
+		uint16_t j = *link;
+		while(waits->waits[j].transition_next!=i)
+			j = waits->waits[j].transition_next;
+		waits->waits[j].transition_next = wait->transition_next;
+	}
+	executor->slots[wait->slot].waits--;
+	executor->slots[wait->on_slot].waits--;
+	waits->waits[i].transition = NULL;
+	waits->waits[i].next = waits->waits_free;
+	waits->waits_free = i;
+	waits->waits_count--;
+}
+
+void GOFSM_Waits_InitStatic(GOFSM_Waits_t* waits){
+	GOFSM_ASSERT(waits!=NULL);
+	GOFSM_ASSERT(waits->waits!=NULL);
+	GOFSM_ASSERT(waits->buckets!=NULL);
+	GOFSM_ASSERT(waits->transition_buckets!=NULL);
+	// корзина выбирается остатком от деления на ёмкость
+	GOFSM_ASSERT(waits->waits_capacity>0 && waits->waits_capacity<GOFSM_WAIT_NONE);
+	waits->waits_count = 0;
+	waits->waits_free = GOFSM_WAIT_NONE;
+	for(uint16_t i=waits->waits_capacity; i>0; i--){
+		waits->waits[i-1].transition = NULL;
+		waits->waits[i-1].next = waits->waits_free;
+		waits->waits_free = i-1;
+		waits->buckets[i-1] = GOFSM_WAIT_NONE;
+		waits->transition_buckets[i-1] = GOFSM_WAIT_NONE;
+	}
+}
+void GOFSM_Waits_Init(GOFSM_Waits_t* waits, uint16_t waits_capacity){
+	waits->is_dyn = 1;
+
+	waits->waits_capacity = waits_capacity;
+
+	waits->waits = (GOFSM_Wait_t*)malloc(waits_capacity * sizeof(GOFSM_Wait_t));
+	waits->buckets = (uint16_t*)malloc(waits_capacity * sizeof(uint16_t));
+	waits->transition_buckets = (uint16_t*)malloc(waits_capacity * sizeof(uint16_t));
+
+	GOFSM_Waits_InitStatic(waits);
+}
+void GOFSM_Waits_Deinit(GOFSM_Waits_t* waits){
+	if(!waits->is_dyn) return;
+	free(waits->waits);
+	free(waits->buckets);
+	free(waits->transition_buckets);
+}
+
+void GOFSM_Executor_SetWaits(GOFSM_Executor_t* executor, GOFSM_Waits_t* waits){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(executor->waits==NULL || executor->waits->waits_count==0);
+	GOFSM_ASSERT(waits==NULL || waits->waits_capacity>0);
+	executor->waits = waits;
+}
+
+GOFSM_Error_t GOFSM_Executor_WaitFor(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Transition_t* transition, GOFSM_Slot_t on_slot, GOFSM_Node_Index_t on_node){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(executor->waits!=NULL);
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_ASSERT(on_slot<executor->slots_used && executor->slots[on_slot].gofsm!=NULL);
+	GOFSM_Waits_t* waits = executor->waits;
+	GOFSM_Executor_Unwait(executor, transition);
+	if(waits->waits_free==GOFSM_WAIT_NONE)
+		return GOFSM_Error_OwerstackWaits;
+
+	uint16_t i = waits->waits_free;
+	GOFSM_Wait_t* wait = waits->waits+i;
+	waits->waits_free = wait->next;
+	waits->waits_count++;
+	uint16_t* head = waits->buckets+GOFSM_Waits_Bucket(waits, on_slot, on_node);
+	wait->transition = transition;
+	wait->slot = slot;
+	wait->on_slot = on_slot;
+	wait->on_node = on_node;
+	wait->next = *head;
+	*head = i;
+	uint16_t* transition_head = waits->transition_buckets+GOFSM_Waits_TransitionBucket(waits, transition);
+	wait->transition_next = *transition_head;
+	*transition_head = i;
+	executor->slots[slot].waits++;
+	executor->slots[on_slot].waits++;
+
+	uint8_t is_met = executor->slots[on_slot].gofsm->current_node_index==on_node;
+	GOFSM_Transition_SetState(executor->slots[slot].gofsm, transition,
+		is_met ? GOFSM_Transition_State_Available : GOFSM_Transition_State_Blocked);
+	return GOFSM_Error_No;
+}
+void GOFSM_Executor_Unwait(GOFSM_Executor_t* executor, GOFSM_Transition_t* transition){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_Waits_t* waits = executor->waits;
+	if(waits==NULL || waits->waits_count==0) return;
+	uint16_t i = waits->transition_buckets[GOFSM_Waits_TransitionBucket(waits, transition)];
+	for(; i!=GOFSM_WAIT_NONE; i=waits->waits[i].transition_next){
+		if(waits->waits[i].transition!=transition) continue;
+		uint16_t bucket = GOFSM_Waits_Bucket(waits, waits->waits[i].on_slot, waits->waits[i].on_node);
+		uint16_t prev = GOFSM_WAIT_NONE;
+		for(uint16_t j=waits->buckets[bucket]; j!=i; j=waits->waits[j].next)
+			prev = j;
+		GOFSM_Waits_Release(executor, bucket, prev, i);
+		return;
+	}
+}
+
+// Автомат on_slot вошёл в on_node (is_met) или вышел из неё: переключаются только подписанные переходы
+static void GOFSM_Executor_Notify(GOFSM_Executor_t* executor, GOFSM_Slot_t on_slot, GOFSM_Node_Index_t on_node, uint8_t is_met){
+	GOFSM_Waits_t* waits = executor->waits;
+	for(uint16_t i=waits->buckets[GOFSM_Waits_Bucket(waits, on_slot, on_node)]; i!=GOFSM_WAIT_NONE; i=waits->waits[i].next){
+		GOFSM_Wait_t* wait = waits->waits+i;
+		if(wait->on_slot!=on_slot || wait->on_node!=on_node) continue;
+		GOFSM_Transition_SetState(executor->slots[wait->slot].gofsm, wait->transition,
+			is_met ? GOFSM_Transition_State_Available : GOFSM_Transition_State_Blocked);
+		if(is_met)
+			executor->stats.wakeups++;
+	}
+}
+
+// Добавление слота в конец списка его класса
+static void GOFSM_Class_Link(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_Executor_Class_t* priority_class = executor->classes+entry->priority_class;
+	entry->class_next = GOFSM_SLOT_NONE;
+	entry->class_prev = priority_class->tail;
+	if(priority_class->tail!=GOFSM_SLOT_NONE)
+		executor->slots[priority_class->tail].class_next = slot;
+	else
+		priority_class->head = slot;
+	priority_class->tail = slot;
+}
+static void GOFSM_Class_Unlink(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_Executor_Class_t* priority_class = executor->classes+entry->priority_class;
+	if(priority_class->cursor==slot)
+		priority_class->cursor = entry->class_next;
+	if(entry->class_prev!=GOFSM_SLOT_NONE)
+		executor->slots[entry->class_prev].class_next = entry->class_next;
+	else
+		priority_class->head = entry->class_next;
+	if(entry->class_next!=GOFSM_SLOT_NONE)
+		executor->slots[entry->class_next].class_prev = entry->class_prev;
+	else
+		priority_class->tail = entry->class_prev;
+}
+
+void GOFSM_Executor_InitStatic(GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(executor->slots!=NULL);
+	GOFSM_ASSERT(executor->wheel!=NULL);
+	GOFSM_ASSERT(executor->wheel_size!=0 && (executor->wheel_size & (executor->wheel_size-1))==0);
+	GOFSM_ASSERT(executor->slots_capacity<GOFSM_SLOT_NONE);
+	executor->slots_count = 0;
+	executor->slots_used = 0;
+	executor->slots_free = GOFSM_SLOT_NONE;
+	executor->waits = NULL;
+	executor->barriers = NULL;
+	executor->barriers_ready = NULL;
+	executor->clock = NULL;
+	executor->budget = 0;
+	memset(executor->classes, 0, sizeof(executor->classes));
+	for(uint8_t c=0; c<GOFSM_EXECUTOR_CLASSES; c++){
+		executor->classes[c].head = GOFSM_SLOT_NONE;
+		executor->classes[c].tail = GOFSM_SLOT_NONE;
+		executor->classes[c].cursor = GOFSM_SLOT_NONE;
+	}
+	executor->now = 0;
+	memset(&executor->stats, 0, sizeof(executor->stats));
+	for(GOFSM_Slot_t i=0; i<executor->wheel_size; i++)
+		executor->wheel[i] = GOFSM_SLOT_NONE;
+}
+void GOFSM_Executor_Init(GOFSM_Executor_t* executor, GOFSM_Slot_t slots_capacity, GOFSM_Slot_t wheel_size){
+	executor->is_dyn = 1;
+
+	executor->slots_capacity = slots_capacity;
+	executor->wheel_size = wheel_size;
+
+	executor->slots = (GOFSM_Executor_Slot_t*)malloc(slots_capacity * sizeof(GOFSM_Executor_Slot_t));
+	executor->wheel = (GOFSM_Slot_t*)malloc(wheel_size * sizeof(GOFSM_Slot_t));
+
+	GOFSM_Executor_InitStatic(executor);
+}
+void GOFSM_Executor_Deinit(GOFSM_Executor_t* executor){
+	if(!executor->is_dyn) return;
+	free(executor->slots);
+	free(executor->wheel);
+}
+
+static void GOFSM_Barrier_Ready(GOFSM_Barrier_t* barrier){
+	if(barrier->is_ready) return;
+	barrier->is_ready = 1;
+	barrier->next_ready = barrier->executor->barriers_ready;
+	barrier->executor->barriers_ready = barrier;
+}
+
+// Удалённый слот выходит из всех групп: его приход не засчитывается, оставшиеся участники
+// собираются без него. Порядок участников в группе при этом меняется
+static void GOFSM_Barrier_Withdraw(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	for(GOFSM_Barrier_t* barrier=executor->barriers; barrier!=NULL; barrier=barrier->next){
+		uint8_t i = 0;
+		while(i<barrier->members_count){
+			if(barrier->slots[i]!=slot){
+				i++;
+				continue;
+			}
+			GOFSM_Transition_Barrier_t* member = barrier->members[i];
+			if(member->is_arrived)
+				barrier->arrived_count--;
+			member->is_arrived = 0;
+			member->is_released = 0;
+			member->barrier = NULL;
+			barrier->members_count--;
+			barrier->members[i] = barrier->members[barrier->members_count];
+			barrier->slots[i] = barrier->slots[barrier->members_count];
+		}
+		if(barrier->members_count!=0 && barrier->arrived_count==barrier->members_count)
+			GOFSM_Barrier_Ready(barrier);
+	}
+}
+
+GOFSM_Error_t GOFSM_Executor_Add(GOFSM_Executor_t* executor, GOFSM_t* gofsm, GOFSM_Slot_t* slot){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_Slot_t index;
+	if(executor->slots_free!=GOFSM_SLOT_NONE){
+		index = executor->slots_free;
+		executor->slots_free = executor->slots[index].deadline_next;
+	}else if(executor->slots_used<executor->slots_capacity){
+		index = executor->slots_used++;
+	}else{
+		return GOFSM_Error_OwerstackSlots;
+	}
+	GOFSM_Executor_Slot_t* entry = executor->slots+index;
+	memset(entry, 0, sizeof(*entry));
+	entry->gofsm = gofsm;
+	gofsm->refs++;
+	entry->last_node_index = gofsm->current_node_index;
+	entry->ran_tick = executor->now;
+	entry->priority_class = GOFSM_Class_Normal;
+	GOFSM_Class_Link(executor, index);
+	executor->slots_count++;
+	if(slot!=NULL)
+		*slot = index;
+	return GOFSM_Error_No;
+}
+void GOFSM_Executor_Remove(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_Executor_Unlink(executor, slot);
+	GOFSM_Waits_t* waits = executor->waits;
+	if(waits!=NULL && executor->slots[slot].waits!=0){
+		for(uint16_t bucket=0; bucket<waits->waits_capacity; bucket++){
+			uint16_t prev = GOFSM_WAIT_NONE;
+			uint16_t i = waits->buckets[bucket];
+			while(i!=GOFSM_WAIT_NONE){
+				uint16_t next = waits->waits[i].next;
+				if(waits->waits[i].slot==slot || waits->waits[i].on_slot==slot)
+					GOFSM_Waits_Release(executor, bucket, prev, i);
+				else
+					prev = i;
+				i = next;
+			}
+		}
+	}
+	if(executor->slots[slot].pins!=0)
+		GOFSM_Barrier_Withdraw(executor, slot);
+	GOFSM_Class_Unlink(executor, slot);
+	executor->slots[slot].gofsm->refs--;
+	executor->slots[slot].gofsm = NULL;
+	executor->slots[slot].deadline_next = executor->slots_free;
+	executor->slots_free = slot;
+	executor->slots_count--;
+}
+
+void GOFSM_Executor_SetTarget(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Node_Index_t node_index, uint32_t deadline_ticks, GOFSM_Node_Index_t fallback_node_index){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_SetTarget(entry->gofsm, node_index);
+	GOFSM_Executor_SetDeadline(executor, slot, deadline_ticks, fallback_node_index);
+}
+void GOFSM_Executor_SetDeadline(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, uint32_t deadline_ticks, GOFSM_Node_Index_t fallback_node_index){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_Executor_Unlink(executor, slot);
+	if(deadline_ticks==0) return;
+	entry->deadline_tick = executor->now+deadline_ticks;
+	entry->deadline_target = entry->gofsm->target_node_index;
+	entry->fallback_node_index = fallback_node_index;
+	GOFSM_Executor_Link(executor, slot);
+}
+void GOFSM_Executor_CancelDeadline(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_Executor_Unlink(executor, slot);
+}
+
+// Корзина текущего тика: сроки этого оборота истекают, остальные ждут следующего
+static void GOFSM_Executor_Expire(GOFSM_Executor_t* executor){
+	GOFSM_Slot_t slot = executor->wheel[executor->now & (executor->wheel_size-1)];
+	while(slot!=GOFSM_SLOT_NONE){
+		GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+		GOFSM_Slot_t next = entry->deadline_next;
+		if(entry->deadline_tick==executor->now){
+			GOFSM_Executor_Unlink(executor, slot);
+			GOFSM_t* gofsm = entry->gofsm;
+			if(gofsm->target_node_index==entry->deadline_target && gofsm->current_node_index!=entry->deadline_target){
+				executor->stats.aborts++;
+				GOFSM_Abort(gofsm, entry->fallback_node_index);
+			}
+		}
+		slot = next;
+	}
+}
+
+static GOFSM_Transition_Result_t GOFSM_Barrier_Function(GOFSM_Transition_t* transition){
+	GOFSM_Transition_Barrier_t* member = (GOFSM_Transition_Barrier_t*)transition;
+	if(member->is_released){
+		GOFSM_Transition_Result_t result = GOFSM_Transition_Result_Success;
+		if(member->function!=NULL)
+			result = member->function(transition);
+		if(result==GOFSM_Transition_Result_Success)
+			member->is_released = 0;
+		return result;
+	}
+	GOFSM_Barrier_t* barrier = member->barrier;
+	if(barrier!=NULL && !member->is_arrived){
+		member->is_arrived = 1;
+		barrier->arrived_count++;
+		if(barrier->arrived_count==barrier->members_count)
+			GOFSM_Barrier_Ready(barrier);
+	}
+	return GOFSM_Transition_Result_Failure;
+}
+
+// Участник группы, дошедший до барьера и ещё не отпущенный
+static GOFSM_Transition_Barrier_t* GOFSM_Barrier_Waiting(const GOFSM_t* gofsm){
+	GOFSM_Transition_t* transition = gofsm->transition_current;
+	if(transition==NULL || transition->function!=GOFSM_Barrier_Function) return NULL;
+	GOFSM_Transition_Barrier_t* member = (GOFSM_Transition_Barrier_t*)transition;
+	return member->is_arrived ? member : NULL;
+}
+
+// Отпускание действует, пока барьерный переход остаётся текущим. Участник, которого тик увёл
+// на другое ребро, теряет его и при возвращении на барьер снова ждёт группу
+static void GOFSM_Barrier_Expire(const GOFSM_t* gofsm, GOFSM_Transition_t* before){
+	if(before==NULL || before->function!=GOFSM_Barrier_Function || before==gofsm->transition_current) return;
+	((GOFSM_Transition_Barrier_t*)before)->is_released = 0;
+}
+
+void GOFSM_Barrier_InitStatic(GOFSM_Barrier_t* barrier){
+	GOFSM_ASSERT(barrier!=NULL);
+	GOFSM_ASSERT(barrier->members!=NULL);
+	GOFSM_ASSERT(barrier->slots!=NULL);
+	barrier->members_count = 0;
+	barrier->arrived_count = 0;
+	barrier->next_ready = NULL;
+	barrier->next = NULL;
+	barrier->executor = NULL;
+	barrier->fired = 0;
+	barrier->is_ready = 0;
+}
+void GOFSM_Barrier_Init(GOFSM_Barrier_t* barrier, uint8_t members_capacity){
+	barrier->is_dyn = 1;
+
+	barrier->members_capacity = members_capacity;
+
+	barrier->members = (GOFSM_Transition_Barrier_t**)malloc(members_capacity * sizeof(GOFSM_Transition_Barrier_t*));
+	barrier->slots = (GOFSM_Slot_t*)malloc(members_capacity * sizeof(GOFSM_Slot_t));
+
+	GOFSM_Barrier_InitStatic(barrier);
+}
+void GOFSM_Barrier_Deinit(GOFSM_Barrier_t* barrier){
+	if(barrier->executor!=NULL){
+		// структуры упакованы, поэтому без указателя на поле next
+		GOFSM_Executor_t* executor = barrier->executor;
+		if(executor->barriers==barrier)
+			executor->barriers = barrier->next;
+		else{
+			GOFSM_Barrier_t* prev = executor->barriers;
+			while(prev->next!=barrier)
+				prev = prev->next;
+			prev->next = barrier->next;
+		}
+		barrier->executor = NULL;
+	}
+	if(!barrier->is_dyn) return;
+	free(barrier->members);
+	free(barrier->slots);
+}
+
+void GOFSM_Transition_InitBarrier(GOFSM_Transition_Barrier_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function){
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_Transition_Init(&transition->transition, source_node_index, destination_node_index, GOFSM_Barrier_Function);
+	transition->function = function;
+	transition->barrier = NULL;
+	transition->is_arrived = 0;
+	transition->is_released = 0;
+}
+
+GOFSM_Error_t GOFSM_Executor_AddBarrier(GOFSM_Executor_t* executor, GOFSM_Barrier_t* barrier, GOFSM_Slot_t slot, GOFSM_Transition_Barrier_t* transition){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(barrier!=NULL);
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_ASSERT(barrier->executor==NULL || barrier->executor==executor);
+	if(barrier->members_count==barrier->members_capacity)
+		return GOFSM_Error_OwerstackSlots;
+	if(barrier->executor==NULL){
+		barrier->next = executor->barriers;
+		executor->barriers = barrier;
+	}
+	barrier->executor = executor;
+	barrier->members[barrier->members_count] = transition;
+	barrier->slots[barrier->members_count] = slot;
+	barrier->members_count++;
+	executor->slots[slot].pins++;
+	transition->barrier = barrier;
+	return GOFSM_Error_No;
+}
+
+// GOFSM_OnTick слота с замером стоимости
+static void GOFSM_Executor_Run(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	if(executor->clock==NULL){
+		GOFSM_OnTick(entry->gofsm);
+		return;
+	}
+	uint32_t start = executor->clock();
+	GOFSM_OnTick(entry->gofsm);
+	uint32_t cost = executor->clock()-start;
+	entry->cost = entry->cost-entry->cost/8+cost/8;
+}
+
+// Уведомление ожидающих о смене ноды и снятие ненужного срока после тика слота
+static void GOFSM_Executor_AfterTick(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_t* gofsm = entry->gofsm;
+	if(gofsm->current_node_index!=entry->last_node_index){
+		GOFSM_Node_Index_t last_node_index = entry->last_node_index;
+		entry->last_node_index = gofsm->current_node_index;
+		if(entry->waits!=0){
+			GOFSM_Executor_Notify(executor, slot, last_node_index, 0);
+			GOFSM_Executor_Notify(executor, slot, gofsm->current_node_index, 1);
+		}
+	}
+	// цель достигнута или сменена в обход исполнителя — срок больше не нужен
+	if(entry->is_deadline && (gofsm->current_node_index==entry->deadline_target
+		|| gofsm->target_node_index!=entry->deadline_target))
+		GOFSM_Executor_Unlink(executor, slot);
+}
+
+// Собравшиеся группы: все участники отпускаются и выполняют барьерный переход на этом же тике.
+// Группа, участник которой ушёл с барьера после сборки, ждёт дальше
+static void GOFSM_Executor_FireBarriers(GOFSM_Executor_t* executor){
+	while(executor->barriers_ready!=NULL){
+		GOFSM_Barrier_t* barrier = executor->barriers_ready;
+		executor->barriers_ready = barrier->next_ready;
+		barrier->is_ready = 0;
+		if(barrier->arrived_count!=barrier->members_count) continue;
+		barrier->arrived_count = 0;
+		barrier->fired++;
+		executor->stats.barriers++;
+		for(uint8_t i=0; i<barrier->members_count; i++){
+			barrier->members[i]->is_arrived = 0;
+			barrier->members[i]->is_released = 1;
+		}
+		for(uint8_t i=0; i<barrier->members_count; i++){
+			GOFSM_Slot_t slot = barrier->slots[i];
+			GOFSM_t* gofsm = executor->slots[slot].gofsm;
+			executor->slots[slot].is_parked = 0;
+			GOFSM_Executor_Run(executor, slot);
+			// тик мог выбрать другое ребро: отпускание не переносится на следующий приход
+			GOFSM_Barrier_Expire(gofsm, &barrier->members[i]->transition);
+			GOFSM_Executor_AfterTick(executor, slot);
+		}
+	}
+}
+
+// Причина снять парковку. Изменение общего графа через шаблон или другой клон видно только по эпохе владельца
+static uint8_t GOFSM_Executor_IsWoken(const GOFSM_t* gofsm){
+	const GOFSM_t* root = gofsm->graph_owner!=NULL ? gofsm->graph_owner : gofsm;
+	return gofsm->is_graph_reconfigured || gofsm->is_target_change || gofsm->is_dispatched
+		|| root->graph_epoch!=gofsm->graph_epoch_seen;
+}
+
+// Автомату нужен тик: не припаркован без причины и не стоит в цели без ожидающего уведомления
+static uint8_t GOFSM_Executor_IsDue(const GOFSM_Executor_Slot_t* entry){
+	const GOFSM_t* gofsm = entry->gofsm;
+	if(entry->is_parked)
+		return GOFSM_Executor_IsWoken(gofsm);
+	if(gofsm->is_dispatched) return 1;
+	return gofsm->current_node_index!=gofsm->target_node_index || gofsm->is_arrival_pending;
+}
+
+static void GOFSM_Executor_Step(GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+	GOFSM_t* gofsm = entry->gofsm;
+	entry->ran_tick = executor->now;
+	if(entry->is_parked){
+		if(!GOFSM_Executor_IsWoken(gofsm)){
+			executor->stats.parked++;
+			return;
+		}
+		entry->is_parked = 0;
+	}
+	// путь может пойти в обход барьера: участие снимается и восстанавливается новым приходом
+	GOFSM_Transition_Barrier_t* member = GOFSM_Barrier_Waiting(gofsm);
+	if(member!=NULL){
+		member->is_arrived = 0;
+		member->barrier->arrived_count--;
+	}
+	GOFSM_Transition_t* before = gofsm->transition_current;
+	GOFSM_Executor_Run(executor, slot);
+	GOFSM_Barrier_Expire(gofsm, before);
+	uint8_t is_unchanged = !gofsm->is_graph_reconfigured && !gofsm->is_target_change && !gofsm->is_dispatched;
+	// пути нет или ждём группу, и ничего не изменилось: повторные тики дадут тот же результат
+	if(is_unchanged && ((gofsm->transition_current==NULL && gofsm->current_node_index!=gofsm->target_node_index)
+		|| GOFSM_Barrier_Waiting(gofsm)!=NULL))
+		entry->is_parked = 1;
+	GOFSM_Executor_AfterTick(executor, slot);
+}
+
+void GOFSM_Executor_Tick(GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(executor!=NULL);
+	uint8_t is_budget = executor->budget!=0 && executor->clock!=NULL;
+	uint32_t start = is_budget ? executor->clock() : 0;
+	uint8_t is_shedding = 0;
+	for(uint8_t c=0; c<GOFSM_EXECUTOR_CLASSES; c++){
+		GOFSM_Executor_Class_t* priority_class = executor->classes+c;
+		// обход по кругу от курсора: отброшенные на прошлом тике слоты идут первыми
+		GOFSM_Slot_t first = priority_class->cursor!=GOFSM_SLOT_NONE ? priority_class->cursor : priority_class->head;
+		uint8_t is_class_shed = 0;
+		GOFSM_Slot_t slot = first;
+		// ограничение на случай удаления слотов из обработчиков во время обхода
+		GOFSM_Slot_t steps = executor->slots_used;
+		for(; slot!=GOFSM_SLOT_NONE && steps>0; steps--){
+			GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+			GOFSM_Slot_t next = entry->class_next!=GOFSM_SLOT_NONE ? entry->class_next : priority_class->head;
+			if(next==first)
+				next = GOFSM_SLOT_NONE;
+			if(entry->gofsm==NULL){
+				slot = next;
+				continue;
+			}
+			if(!is_shedding && is_budget && c!=GOFSM_Class_Critical && executor->clock()-start>=executor->budget)
+				is_shedding = 1;
+			if(!is_shedding){
+				priority_class->ticked++;
+				GOFSM_Executor_Step(executor, slot);
+			}else if(GOFSM_Executor_IsDue(entry)){
+				if(!is_class_shed)
+					priority_class->cursor = slot;
+				is_class_shed = 1;
+				priority_class->skipped++;
+				if(executor->now-entry->ran_tick>priority_class->max_lag)
+					priority_class->misses++;
+			}else{
+				entry->ran_tick = executor->now;
+			}
+			slot = next;
+		}
+		if(!is_class_shed)
+			priority_class->cursor = GOFSM_SLOT_NONE;
+	}
+	GOFSM_Executor_FireBarriers(executor);
+	executor->now++;
+	executor->stats.ticks++;
+	GOFSM_Executor_Expire(executor);
+}
+
+uint8_t GOFSM_Executor_IsIdle(const GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(executor!=NULL);
+	for(GOFSM_Slot_t slot=0; slot<executor->slots_used; slot++){
+		const GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+		if(entry->gofsm!=NULL && GOFSM_Executor_IsDue(entry)) return 0;
+	}
+	return 1;
+}
+
+uint32_t GOFSM_Executor_NextDeadline(const GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(executor!=NULL);
+	uint32_t next = UINT32_MAX;
+	for(GOFSM_Slot_t slot=0; slot<executor->slots_used; slot++){
+		const GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+		if(entry->gofsm==NULL || !entry->is_deadline) continue;
+		// срок ставится относительно now до инкремента, первая проверка — через deadline_tick-now тиков
+		uint32_t ticks = entry->deadline_tick-executor->now-1;
+		if(ticks<next)
+			next = ticks;
+	}
+	return next;
+}
+
+void GOFSM_Executor_Advance(GOFSM_Executor_t* executor, uint32_t ticks){
+	GOFSM_ASSERT(executor!=NULL);
+	for(; ticks>0; ticks--){
+		executor->now++;
+		GOFSM_Executor_Expire(executor);
+	}
+}
+
+void GOFSM_Executor_SetClock(GOFSM_Executor_t* executor, GOFSM_Clock_t clock){
+	GOFSM_ASSERT(executor!=NULL);
+	executor->clock = clock;
+}
+
+uint32_t GOFSM_Executor_Load(const GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(executor!=NULL);
+	uint32_t load = 0;
+	for(GOFSM_Slot_t slot=0; slot<executor->slots_used; slot++)
+		if(executor->slots[slot].gofsm!=NULL)
+			load += executor->slots[slot].cost;
+	return load;
+}
+
+// На слот ссылаются по индексу ожидания, барьеры или переходы io_uring своего исполнителя
+static uint8_t GOFSM_Executor_IsPinned(const GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	return executor->slots[slot].pins!=0 || executor->slots[slot].waits!=0;
+}
+
+GOFSM_Error_t GOFSM_Executor_Migrate(GOFSM_Executor_t* from, GOFSM_Slot_t slot, GOFSM_Executor_t* to, GOFSM_Slot_t* new_slot){
+	GOFSM_ASSERT(from!=NULL && to!=NULL && from!=to);
+	GOFSM_ASSERT(slot<from->slots_used && from->slots[slot].gofsm!=NULL);
+	if(GOFSM_Executor_IsPinned(from, slot))
+		return GOFSM_Error_Unsupported;
+	GOFSM_Executor_Slot_t* entry = from->slots+slot;
+	GOFSM_Slot_t index;
+	GOFSM_Error_t error = GOFSM_Executor_Add(to, entry->gofsm, &index);
+	if(error!=GOFSM_Error_No)
+		return error;
+	GOFSM_Executor_Slot_t* moved = to->slots+index;
+	moved->last_node_index = entry->last_node_index;
+	moved->is_parked = entry->is_parked;
+	moved->cost = entry->cost;
+	GOFSM_Executor_SetClass(to, index, (GOFSM_Class_t)entry->priority_class);
+	if(entry->is_deadline){
+		moved->deadline_tick = to->now+(entry->deadline_tick-from->now);
+		moved->deadline_target = entry->deadline_target;
+		moved->fallback_node_index = entry->fallback_node_index;
+		GOFSM_Executor_Link(to, index);
+	}
+	GOFSM_Executor_Remove(from, slot);
+	to->stats.migrations++;
+	if(new_slot!=NULL)
+		*new_slot = index;
+	return GOFSM_Error_No;
+}
+
+uint8_t GOFSM_Executor_Balance(GOFSM_Executor_t** shards, uint8_t shards_count, uint8_t max_moves){
+	GOFSM_ASSERT(shards!=NULL);
+	uint8_t moves = 0;
+	for(; moves<max_moves; moves++){
+		uint8_t hot = 0, cold = 0;
+		uint32_t hot_load = 0, cold_load = UINT32_MAX;
+		for(uint8_t i=0; i<shards_count; i++){
+			uint32_t load = GOFSM_Executor_Load(shards[i]);
+			if(load>=hot_load){ hot = i; hot_load = load; }
+			if(load<cold_load && shards[i]->slots_count<shards[i]->slots_capacity){ cold = i; cold_load = load; }
+		}
+		if(hot==cold || cold_load==UINT32_MAX || hot_load<=cold_load) break;
+		// перенос стоимости cost меняет разрыв на |gap-2*cost|: лучший автомат — ближе всего к половине разрыва
+		uint32_t gap = hot_load-cold_load;
+		GOFSM_Executor_t* from = shards[hot];
+		// кандидаты перебираются по возрастанию (остаток разрыва, слот): после отказа переноса
+		// берётся следующий за отвергнутым, без памяти под список отвергнутых
+		uint32_t rejected_gap = 0;
+		GOFSM_Slot_t rejected = GOFSM_SLOT_NONE;
+		uint8_t is_moved = 0;
+		while(!is_moved){
+			GOFSM_Slot_t best = GOFSM_SLOT_NONE;
+			uint32_t best_gap = gap;
+			for(GOFSM_Slot_t slot=0; slot<from->slots_used; slot++){
+				const GOFSM_Executor_Slot_t* entry = from->slots+slot;
+				if(entry->gofsm==NULL || entry->cost==0 || entry->cost>=gap) continue;
+				uint32_t doubled = 2*entry->cost;
+				uint32_t remaining = doubled>gap ? doubled-gap : gap-doubled;
+				if(rejected!=GOFSM_SLOT_NONE && (remaining<rejected_gap || (remaining==rejected_gap && slot<=rejected)))
+					continue;
+				if(remaining<best_gap){ best = slot; best_gap = remaining; }
+			}
+			if(best==GOFSM_SLOT_NONE) break;
+			if(GOFSM_Executor_Migrate(from, best, shards[cold], NULL)==GOFSM_Error_No){
+				is_moved = 1;
+			}else{
+				rejected = best;
+				rejected_gap = best_gap;
+			}
+		}
+		if(!is_moved) break;
+	}
+	return moves;
+}
+
+void GOFSM_Executor_SetClass(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Class_t priority_class){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_ASSERT(priority_class<GOFSM_EXECUTOR_CLASSES);
+	GOFSM_Class_Unlink(executor, slot);
+	executor->slots[slot].priority_class = (uint8_t)priority_class;
+	GOFSM_Class_Link(executor, slot);
+}
+void GOFSM_Executor_SetClassLag(GOFSM_Executor_t* executor, GOFSM_Class_t priority_class, uint16_t max_lag){
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(priority_class<GOFSM_EXECUTOR_CLASSES);
+	executor->classes[priority_class].max_lag = max_lag;
+}
+void GOFSM_Executor_SetBudget(GOFSM_Executor_t* executor, uint32_t budget){
+	GOFSM_ASSERT(executor!=NULL);
+	executor->budget = budget;
+}
@@ -0,0 +1,259 @@
+#ifndef GOFSM_EXECUTOR_H
+#define GOFSM_EXECUTOR_H
+
+#include <GOFSM/gofsm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Исполнитель: один GOFSM_Executor_Tick() выполняет GOFSM_OnTick() всех зарегистрированных автоматов.
+// Автомат занимает слот, индекс слота не меняется до удаления.
+// Сроки целей хранятся в общем хешированном колесе таймеров: корзина на тик (по модулю размера колеса),
+// постановка и снятие за O(1), на тике просматривается одна корзина.
+// Сроки дальше одного оборота колеса просматриваются раз в оборот.
+typedef uint16_t GOFSM_Slot_t;
+#define GOFSM_SLOT_NONE 0xFFFF
+
+typedef struct __attribute__((packed)){
+	GOFSM_t* gofsm;                   // NULL — слот свободен
+	uint32_t deadline_tick;
+	GOFSM_Slot_t deadline_next;       // список корзины колеса; для свободного слота — список свободных
+	GOFSM_Slot_t deadline_prev;
+	GOFSM_Node_Index_t deadline_target;
+	GOFSM_Node_Index_t fallback_node_index;
+	GOFSM_Node_Index_t last_node_index;   // нода на прошлом тике, для уведомления ожидающих
+	uint8_t is_deadline;
+	uint8_t is_parked;
+	uint32_t cost;                    // скользящее среднее длительности GOFSM_OnTick в единицах часов исполнителя
+	uint32_t ran_tick;                // последний тик, на котором слот обслужен
+	GOFSM_Slot_t class_next;          // список класса приоритета
+	GOFSM_Slot_t class_prev;
+	uint8_t priority_class;
+	uint8_t pins;                     // барьеры и переходы io_uring, хранящие индекс слота: слот не переносится
+	uint16_t waits;                   // ожидания, где слот ждущий или наблюдаемый: слот тоже не переносится
+}GOFSM_Executor_Slot_t;
+
+// Классы приоритета: на тике классы обслуживаются по порядку. При заданном бюджете тика классы
+// ниже критического отбрасываются, как только бюджет исчерпан, и продолжают со следующего тика
+// с места остановки. Класс 0 обслуживается всегда
+#define GOFSM_EXECUTOR_CLASSES 4
+typedef enum{
+	GOFSM_Class_Critical = 0,
+	GOFSM_Class_Normal = 1,           // по умолчанию
+	GOFSM_Class_Low = 2,
+	GOFSM_Class_Background = 3
+}GOFSM_Class_t;
+
+typedef struct __attribute__((packed)){
+	GOFSM_Slot_t head;
+	GOFSM_Slot_t tail;
+	GOFSM_Slot_t cursor;              // с этого слота начнётся следующий тик класса
+	uint16_t max_lag;                 // допустимое число пропущенных подряд тиков
+	uint32_t ticked;
+	uint32_t skipped;                 // слоты с работой, отброшенные по бюджету
+	uint32_t misses;                  // пропуски сверх max_lag
+}GOFSM_Executor_Class_t;
+
+// Ожидание состояния другого автомата: переход ожидающего слота доступен, пока автомат on_slot стоит в on_node.
+// Индекс подписок — хеш-таблица по (on_slot, on_node): при входе и выходе из ноды
+// перебираются только подписки на эту пару. Вторая хеш-таблица по переходу находит
+// ожидание для GOFSM_Executor_Unwait без перебора всей таблицы
+typedef struct __attribute__((packed)){
+	GOFSM_Transition_t* transition;   // NULL — запись свободна
+	GOFSM_Slot_t slot;
+	GOFSM_Slot_t on_slot;
+	GOFSM_Node_Index_t on_node;
+	uint16_t next;                    // следующая запись корзины или списка свободных
+	uint16_t transition_next;         // следующая запись корзины по переходу
+}GOFSM_Wait_t;
+
+typedef struct __attribute__((packed)){
+	uint16_t waits_capacity;          // не меньше 1
+	uint16_t waits_count;
+	uint16_t waits_free;
+	GOFSM_Wait_t* waits;
+	uint16_t* buckets;                // waits_capacity корзин по (on_slot, on_node)
+	uint16_t* transition_buckets;     // waits_capacity корзин по переходу
+	uint8_t is_dyn;
+}GOFSM_Waits_t;
+
+#define GOFSM_WAITS_STATIC_ALLOCATE(STORAGE, name, WCOUNT)                  \
+	STORAGE GOFSM_Wait_t name##_waits[WCOUNT];                                \
+	STORAGE uint16_t name##_buckets[WCOUNT];                                  \
+	STORAGE uint16_t name##_transition_buckets[WCOUNT];                       \
+	STORAGE GOFSM_Waits_t name = {                                            \
+		.waits_capacity     = (WCOUNT),                                       \
+		.waits              = name##_waits,                                   \
+		.buckets            = name##_buckets,                                 \
+		.transition_buckets = name##_transition_buckets                       \
+	}
+
+// Барьерный переход: выполняется только вместе с остальными переходами группы.
+// Автомат, дошедший до барьерного перехода, ждёт без повторов (слот паркуется), исполнитель
+// выполняет все переходы группы в конце тика, на котором группа собралась полностью.
+// Если функция перехода после срабатывания вернула Failure, переход повторяется как обычный.
+// Отпускание действует, пока барьерный переход остаётся текущим: ушедший с него участник снова ждёт группу
+struct GOFSM_Barrier_t;
+typedef struct __attribute__((packed)){
+	GOFSM_Transition_t transition;
+	GOFSM_Transition_Function_t function;   // пользовательская функция перехода
+	struct GOFSM_Barrier_t* barrier;
+	uint8_t is_arrived;
+	uint8_t is_released;
+}GOFSM_Transition_Barrier_t;
+
+typedef struct __attribute__((packed)) GOFSM_Barrier_t{
+	uint8_t members_capacity;
+	uint8_t members_count;
+	uint8_t arrived_count;
+	GOFSM_Transition_Barrier_t** members;
+	GOFSM_Slot_t* slots;
+	struct GOFSM_Barrier_t* next_ready;
+	struct GOFSM_Barrier_t* next;     // список групп исполнителя
+	struct GOFSM_Executor_t* executor;
+	uint32_t fired;
+	uint8_t is_ready;
+	uint8_t is_dyn;
+}GOFSM_Barrier_t;
+
+#define GOFSM_BARRIER_STATIC_ALLOCATE(STORAGE, name, MCOUNT)                \
+	STORAGE GOFSM_Transition_Barrier_t* name##_members[MCOUNT];               \
+	STORAGE GOFSM_Slot_t name##_slots[MCOUNT];                                \
+	STORAGE GOFSM_Barrier_t name = {                                          \
+		.members_capacity = (MCOUNT),                                         \
+		.members          = name##_members,                                   \
+		.slots            = name##_slots                                      \
+	}
+
+typedef struct __attribute__((packed)){
+	uint32_t ticks;
+	uint32_t aborts;                  // цели, снятые по сроку
+	uint32_t parked;                  // пропущенные вызовы GOFSM_OnTick припаркованных автоматов
+	uint32_t wakeups;                 // переходы, разблокированные по ожиданию
+	uint32_t barriers;                // срабатывания барьеров
+	uint32_t migrations;              // автоматы, перенесённые в этот исполнитель
+}GOFSM_Executor_Stats_t;
+
+// Монотонные часы для замера стоимости тиков (такты, нс — единицы выбирает приложение)
+typedef uint32_t (*GOFSM_Clock_t)(void);
+
+typedef struct __attribute__((packed)) GOFSM_Executor_t{
+	GOFSM_Slot_t slots_capacity;
+	GOFSM_Slot_t slots_count;
+	GOFSM_Slot_t slots_used;          // слоты с индексом не меньше slots_used ни разу не занимались
+	GOFSM_Slot_t slots_free;          // голова списка освобождённых слотов
+	GOFSM_Executor_Slot_t* slots;
+	GOFSM_Slot_t wheel_size;          // степень двойки
+	GOFSM_Slot_t* wheel;
+	GOFSM_Waits_t* waits;
+	GOFSM_Barrier_t* barriers;        // группы с участниками из этого исполнителя
+	GOFSM_Barrier_t* barriers_ready;  // группы, собравшиеся на текущем тике
+	GOFSM_Clock_t clock;              // NULL — стоимость не замеряется
+	uint32_t budget;                  // единиц часов на тик, 0 — без ограничения
+	GOFSM_Executor_Class_t classes[GOFSM_EXECUTOR_CLASSES];
+	uint32_t now;
+	GOFSM_Executor_Stats_t stats;
+	uint8_t is_dyn;
+}GOFSM_Executor_t;
+
+#define GOFSM_EXECUTOR_STATIC_ALLOCATE(STORAGE, name, SCOUNT, WSIZE)        \
+	STORAGE GOFSM_Executor_Slot_t name##_slots[SCOUNT];                       \
+	STORAGE GOFSM_Slot_t name##_wheel[WSIZE];                                 \
+	STORAGE GOFSM_Executor_t name = {                                         \
+		.slots_capacity = (SCOUNT),                                           \
+		.slots          = name##_slots,                                       \
+		.wheel_size     = (WSIZE),                                            \
+		.wheel          = name##_wheel                                        \
+	}
+
+// Использовать строго для исполнителей созданных через GOFSM_EXECUTOR_STATIC_ALLOCATE()
+void GOFSM_Executor_InitStatic(GOFSM_Executor_t* executor);
+
+// Динамическая инициализация. wheel_size — степень двойки, обычно не меньше типичного срока в тиках
+void GOFSM_Executor_Init(GOFSM_Executor_t* executor, GOFSM_Slot_t slots_capacity, GOFSM_Slot_t wheel_size);
+void GOFSM_Executor_Deinit(GOFSM_Executor_t* executor);
+
+GOFSM_Error_t GOFSM_Executor_Add(GOFSM_Executor_t* executor, GOFSM_t* gofsm, GOFSM_Slot_t* slot);
+// Снимает и ожидания, связанные со слотом, и выводит слот из групп барьеров
+void GOFSM_Executor_Remove(GOFSM_Executor_t* executor, GOFSM_Slot_t slot);
+
+static inline GOFSM_t* GOFSM_Executor_Get(const GOFSM_Executor_t* executor, GOFSM_Slot_t slot){
+	return executor->slots[slot].gofsm;
+}
+
+// Цель со сроком: если за deadline_ticks тиков цель не достигнута, ожидающий получает
+// GOFSM_Arrival_Expired и автомат переключается на fallback_node_index.
+// deadline_ticks==0 — без срока. Срок снимается при достижении цели или смене цели в обход исполнителя
+void GOFSM_Executor_SetTarget(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Node_Index_t node_index, uint32_t deadline_ticks, GOFSM_Node_Index_t fallback_node_index);
+// Срок для текущей цели без её переустановки (восстановление, продление)
+void GOFSM_Executor_SetDeadline(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, uint32_t deadline_ticks, GOFSM_Node_Index_t fallback_node_index);
+void GOFSM_Executor_CancelDeadline(GOFSM_Executor_t* executor, GOFSM_Slot_t slot);
+
+// Использовать строго для таблиц созданных через GOFSM_WAITS_STATIC_ALLOCATE()
+void GOFSM_Waits_InitStatic(GOFSM_Waits_t* waits);
+void GOFSM_Waits_Init(GOFSM_Waits_t* waits, uint16_t waits_capacity);
+void GOFSM_Waits_Deinit(GOFSM_Waits_t* waits);
+
+// Подключение таблицы ожиданий (NULL — отключить, только пока подписок нет)
+void GOFSM_Executor_SetWaits(GOFSM_Executor_t* executor, GOFSM_Waits_t* waits);
+
+// Переход автомата slot доступен только пока автомат on_slot стоит в on_node: состояние перехода
+// переключается исполнителем при входе и выходе on_slot из ноды, без опроса в функции перехода.
+// У перехода одно ожидание, повторный вызов заменяет прежнее.
+// Переход должен быть зарегистрирован в автомате slot; GOFSM_Error_OwerstackWaits — таблица заполнена
+GOFSM_Error_t GOFSM_Executor_WaitFor(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Transition_t* transition, GOFSM_Slot_t on_slot, GOFSM_Node_Index_t on_node);
+// Снять ожидание перехода, состояние перехода не меняется
+void GOFSM_Executor_Unwait(GOFSM_Executor_t* executor, GOFSM_Transition_t* transition);
+
+// Использовать строго для групп созданных через GOFSM_BARRIER_STATIC_ALLOCATE()
+void GOFSM_Barrier_InitStatic(GOFSM_Barrier_t* barrier);
+void GOFSM_Barrier_Init(GOFSM_Barrier_t* barrier, uint8_t members_capacity);
+void GOFSM_Barrier_Deinit(GOFSM_Barrier_t* barrier);
+
+// Регистрируется в автомате как обычный переход: GOFSM_AddTransition(gofsm, &barrier_transition->transition)
+void GOFSM_Transition_InitBarrier(GOFSM_Transition_Barrier_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function);
+// Включение перехода автомата slot в группу. GOFSM_Executor_Remove выводит слот из группы:
+// его приход больше не засчитывается, и группа собирается без него. GOFSM_Error_OwerstackSlots — группа заполнена
+GOFSM_Error_t GOFSM_Executor_AddBarrier(GOFSM_Executor_t* executor, GOFSM_Barrier_t* barrier, GOFSM_Slot_t slot, GOFSM_Transition_Barrier_t* transition);
+
+// Автомат без пути к цели или ожидающий на барьере паркуется: GOFSM_OnTick не вызывается, пока не изменится граф,
+// цель или не придёт событие (пробуждение по ожиданию меняет граф). Ожидание на барьере при этом снимается
+void GOFSM_Executor_Tick(GOFSM_Executor_t* executor);
+
+// Замер стоимости GOFSM_OnTick каждого слота (NULL — отключить). Стоимость сглаживается по 8 тикам
+void GOFSM_Executor_SetClock(GOFSM_Executor_t* executor, GOFSM_Clock_t clock);
+// Класс слота; новый слот — GOFSM_Class_Normal. Порядок слотов внутри класса — порядок назначения
+void GOFSM_Executor_SetClass(GOFSM_Executor_t* executor, GOFSM_Slot_t slot, GOFSM_Class_t priority_class);
+// SLO класса: слот с работой, не обслуженный больше max_lag тиков подряд, считается в misses
+void GOFSM_Executor_SetClassLag(GOFSM_Executor_t* executor, GOFSM_Class_t priority_class, uint16_t max_lag);
+// Бюджет тика в единицах часов (требует GOFSM_Executor_SetClock), 0 — без отбрасывания
+void GOFSM_Executor_SetBudget(GOFSM_Executor_t* executor, uint32_t budget);
+
+// Сумма стоимостей слотов — нагрузка исполнителя за тик
+uint32_t GOFSM_Executor_Load(const GOFSM_Executor_t* executor);
+
+// Перенос автомата в другой исполнитель (шард) между тиками обоих: сохраняются состояние автомата
+// со всеми заданными целями и событиями, срок (остаток тиков), парковка и замеренная стоимость.
+// Граф не копируется — автомат переносится по указателю.
+// GOFSM_Error_Unsupported — на слот есть ожидания или слот участвует в барьере либо переходе io_uring,
+// GOFSM_Error_OwerstackSlots — в to нет места
+GOFSM_Error_t GOFSM_Executor_Migrate(GOFSM_Executor_t* from, GOFSM_Slot_t slot, GOFSM_Executor_t* to, GOFSM_Slot_t* new_slot);
+// Выравнивание нагрузки: до max_moves переносов с самого загруженного шарда на наименее загруженный,
+// каждый раз выбирается автомат, лучше всего сокращающий разрыв. Слоты, которые нельзя перенести, пропускаются.
+// Возвращает число переносов
+uint8_t GOFSM_Executor_Balance(GOFSM_Executor_t** shards, uint8_t shards_count, uint8_t max_moves);
+
+// Ни одному автомату тик не нужен: каждый стоит в цели без ожидающего уведомления или припаркован.
+// Цель, событие или изменение графа, заданные в обход тика, снимают простой
+uint8_t GOFSM_Executor_IsIdle(const GOFSM_Executor_t* executor);
+// Тиков до ближайшего срока (0 — истекает на следующем тике), UINT32_MAX — сроков нет
+uint32_t GOFSM_Executor_NextDeadline(const GOFSM_Executor_t* executor);
+// Счёт тиков, пропущенных во время простоя, без вызова GOFSM_OnTick: сроки истекают как на обычных тиках
+void GOFSM_Executor_Advance(GOFSM_Executor_t* executor, uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
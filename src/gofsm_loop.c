@@ -0,0 +1,134 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE     // clock_gettime()
+#endif
+#include <GOFSM/gofsm_loop.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t GOFSM_Loop_Now(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000u+(uint64_t)now.tv_nsec;
+}
+
+// Таймер на момент следующего нужного тика, at==0 — таймер снят
+static void GOFSM_Loop_SetTimer(GOFSM_Loop_t* loop, uint64_t at){
+	struct itimerspec value;
+	memset(&value, 0, sizeof(value));
+	value.it_value.tv_sec = (time_t)(at/1000000000u);
+	value.it_value.tv_nsec = (long)(at%1000000000u);
+	timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &value, NULL);
+}
+
+static void GOFSM_Loop_Arm(GOFSM_Loop_t* loop){
+	uint8_t is_idle = GOFSM_Executor_IsIdle(loop->executor)
+		&& (loop->uring==NULL || loop->uring->sq_pending==0);
+	if(is_idle && !loop->is_idle)
+		loop->stats.idle++;
+	loop->is_idle = is_idle;
+	// прошедший момент срабатывает сразу, ноль снял бы таймер
+	uint64_t at = loop->last_tick_ns+loop->period_ns;
+	if(is_idle){
+		uint32_t next = GOFSM_Executor_NextDeadline(loop->executor);
+		if(next==UINT32_MAX){
+			GOFSM_Loop_SetTimer(loop, 0);
+			return;
+		}
+		at = loop->last_tick_ns+((uint64_t)next+1)*loop->period_ns;
+	}
+	GOFSM_Loop_SetTimer(loop, at!=0 ? at : 1);
+}
+
+GOFSM_Error_t GOFSM_Loop_Init(GOFSM_Loop_t* loop, GOFSM_Executor_t* executor, GOFSM_Uring_t* uring, uint64_t period_ns){
+	GOFSM_ASSERT(loop!=NULL);
+	GOFSM_ASSERT(executor!=NULL);
+	GOFSM_ASSERT(period_ns>0);
+	memset(loop, 0, sizeof(*loop));
+	loop->epoll_fd = -1;
+	loop->event_fd = -1;
+	loop->timer_fd = -1;
+	if(period_ns==0)
+		return GOFSM_Error_Unsupported;
+	loop->executor = executor;
+	loop->uring = uring;
+	loop->period_ns = period_ns;
+	loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	loop->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if(loop->epoll_fd<0 || loop->event_fd<0 || loop->timer_fd<0){
+		GOFSM_Loop_Deinit(loop);
+		return GOFSM_Error_IoSetup;
+	}
+	int fds[3] = {loop->event_fd, loop->timer_fd, uring!=NULL ? uring->fd : -1};
+	for(uint8_t i=0; i<3 && fds[i]>=0; i++){
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = fds[i];
+		if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fds[i], &event)!=0){
+			GOFSM_Loop_Deinit(loop);
+			return GOFSM_Error_IoSetup;
+		}
+	}
+	// первый тик — сразу
+	loop->last_tick_ns = GOFSM_Loop_Now()-period_ns;
+	GOFSM_Loop_SetTimer(loop, 1);
+	return GOFSM_Error_No;
+}
+void GOFSM_Loop_Deinit(GOFSM_Loop_t* loop){
+	if(loop->timer_fd>=0) close(loop->timer_fd);
+	if(loop->event_fd>=0) close(loop->event_fd);
+	if(loop->epoll_fd>=0) close(loop->epoll_fd);
+	loop->timer_fd = -1;
+	loop->event_fd = -1;
+	loop->epoll_fd = -1;
+}
+
+void GOFSM_Loop_Notify(GOFSM_Loop_t* loop){
+	uint64_t one = 1;
+	ssize_t written = write(loop->event_fd, &one, sizeof(one));
+	(void)written;  // EAGAIN — счётчик уже не нулевой, дескриптор и так читаем
+}
+
+static void GOFSM_Loop_PoolNotify(void* context){
+	GOFSM_Loop_Notify((GOFSM_Loop_t*)context);
+}
+void GOFSM_Loop_AttachPool(GOFSM_Loop_t* loop, GOFSM_Pool_t* pool){
+	GOFSM_ASSERT(loop!=NULL);
+	GOFSM_Pool_SetNotify(pool, GOFSM_Loop_PoolNotify, loop);
+}
+
+void GOFSM_Loop_Dispatch(GOFSM_Loop_t* loop){
+	GOFSM_ASSERT(loop!=NULL);
+	uint64_t value;
+	ssize_t drained = read(loop->event_fd, &value, sizeof(value));
+	drained = read(loop->timer_fd, &value, sizeof(value));
+	(void)drained;
+
+	uint64_t now = GOFSM_Loop_Now();
+	uint64_t elapsed = (now-loop->last_tick_ns)/loop->period_ns;
+	if(elapsed>1){
+		uint32_t skipped = elapsed-1>UINT32_MAX ? UINT32_MAX : (uint32_t)(elapsed-1);
+		GOFSM_Executor_Advance(loop->executor, skipped);
+		loop->stats.skipped += skipped;
+	}
+	if(loop->uring!=NULL)
+		GOFSM_Uring_Tick(loop->uring);
+	else
+		GOFSM_Executor_Tick(loop->executor);
+	loop->stats.ticks++;
+	loop->last_tick_ns = now;
+	GOFSM_Loop_Arm(loop);
+}
+
+void GOFSM_Loop_Run(GOFSM_Loop_t* loop){
+	GOFSM_ASSERT(loop!=NULL);
+	struct epoll_event events[3];
+	if(epoll_wait(loop->epoll_fd, events, 3, -1)<0)
+		return;     // EINTR: сигнал, вызывающий повторит
+	GOFSM_Loop_Dispatch(loop);
+}
@@ -0,0 +1,59 @@
+#ifndef GOFSM_LOOP_H
+#define GOFSM_LOOP_H
+
+#include <GOFSM/gofsm_uring.h>
+#include <GOFSM/gofsm_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Встраивание исполнителя в цикл событий (Linux): один дескриптор epoll, который становится читаемым,
+// когда тик нужен — у автомата есть работа, подошёл срок, пришло завершение io_uring или GOFSM_Loop_Notify().
+// Пока все автоматы простаивают (GOFSM_Executor_IsIdle), тики не выполняются и процессор не тратится;
+// тики, пропущенные за время сна, досчитываются GOFSM_Executor_Advance(), чтобы сроки не сдвигались.
+typedef struct __attribute__((packed)){
+	uint32_t ticks;
+	uint32_t skipped;                 // тики, досчитанные после сна
+	uint32_t idle;                    // переходы в простой
+}GOFSM_Loop_Stats_t;
+
+typedef struct __attribute__((packed)){
+	int epoll_fd;
+	int event_fd;
+	int timer_fd;
+	uint64_t period_ns;               // период тика, больше нуля
+	uint64_t last_tick_ns;
+	GOFSM_Executor_t* executor;
+	GOFSM_Uring_t* uring;             // NULL — без io_uring
+	GOFSM_Loop_Stats_t stats;
+	uint8_t is_idle;
+}GOFSM_Loop_t;
+
+// GOFSM_Error_IoSetup — не созданы epoll, eventfd или timerfd.
+// GOFSM_Error_Unsupported — period_ns==0: таймер на прошедший момент крутил бы цикл без сна
+GOFSM_Error_t GOFSM_Loop_Init(GOFSM_Loop_t* loop, GOFSM_Executor_t* executor, GOFSM_Uring_t* uring, uint64_t period_ns);
+void GOFSM_Loop_Deinit(GOFSM_Loop_t* loop);
+
+// Для poll/epoll внешнего цикла: при готовности вызвать GOFSM_Loop_Dispatch()
+static inline int GOFSM_Loop_Fd(const GOFSM_Loop_t* loop){
+	return loop->epoll_fd;
+}
+
+// Новая цель, событие или изменение графа вне тика: дескриптор становится читаемым.
+// Безопасно вызывать из других потоков и обработчиков сигналов
+void GOFSM_Loop_Notify(GOFSM_Loop_t* loop);
+// Рабочие потоки пула вызывают GOFSM_Loop_Notify() по готовности результата:
+// асинхронный переход завершается на ближайшем тике, а не через период
+void GOFSM_Loop_AttachPool(GOFSM_Loop_t* loop, GOFSM_Pool_t* pool);
+
+// Один тик (через GOFSM_Uring_Tick, если кольцо задано) и перевзвод таймера. Не блокируется
+void GOFSM_Loop_Dispatch(GOFSM_Loop_t* loop);
+// Ожидание готовности и GOFSM_Loop_Dispatch(), для процессов без собственного цикла событий
+void GOFSM_Loop_Run(GOFSM_Loop_t* loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+#include <GOFSM/gofsm_names.h>
+
+#define GOFSM_NAMES_SLOT_FREE 0xFF
+#define GOFSM_NAMES_SALT_LIMIT 255
+#define GOFSM_NAMES_DISPLACEMENT_LIMIT 0xFFFF
+
+static uint32_t GOFSM_Names_Hash(const char* name, uint8_t salt){
+	// FNV-1a
+	uint32_t hash = 2166136261u ^ (salt * 0x9E3779B9u);
+	while(*name){
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static uint8_t GOFSM_Names_Slot(uint32_t hash, uint16_t displacement, uint8_t count){
+	// перемешивание (murmur3 fmix32), затем смещение вида f1 + d0*f2 + d1
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
+	uint32_t f1 = hash % count;
+	uint32_t f2 = count>1 ? 1 + (hash >> 16) % (count-1) : 0;
+	return (uint8_t)((f1 + (uint32_t)(displacement / count) * f2 + displacement % count) % count);
+}
+
+// Рабочие массивы на стеке (~1.8 KB), построение выполняется один раз при инициализации
+static uint8_t GOFSM_Names_TryBuild(GOFSM_Names_t* names){
+	uint8_t count = names->names_count;
+	uint32_t hashes[UINT8_MAX];
+	uint8_t key_bucket[UINT8_MAX];
+	uint8_t bucket_size[UINT8_MAX];
+	GOFSM_Node_Index_t members[UINT8_MAX];
+
+	memset(names->slots, GOFSM_NAMES_SLOT_FREE, count);
+	memset(bucket_size, 0, names->buckets_count);
+
+	uint8_t max_size = 0;
+	for(uint8_t i=0; i<count; i++){
+		hashes[i] = GOFSM_Names_Hash(names->names[i], names->salt);
+		key_bucket[i] = hashes[i] % names->buckets_count;
+		bucket_size[key_bucket[i]]++;
+		if(bucket_size[key_bucket[i]]>max_size)
+			max_size = bucket_size[key_bucket[i]];
+	}
+
+	// корзины размещаются по убыванию размера
+	for(uint8_t size=max_size; size>0; size--){
+		for(uint8_t b=0; b<names->buckets_count; b++){
+			if(bucket_size[b]!=size) continue;
+
+			uint8_t members_count = 0;
+			for(uint8_t i=0; i<count; i++)
+				if(key_bucket[i]==b)
+					members[members_count++] = i;
+
+			uint32_t displacement = 0;
+			for(; displacement<=GOFSM_NAMES_DISPLACEMENT_LIMIT; displacement++){
+				uint8_t placed = 0;
+				for(; placed<members_count; placed++){
+					uint8_t slot = GOFSM_Names_Slot(hashes[members[placed]], displacement, count);
+					if(names->slots[slot]!=GOFSM_NAMES_SLOT_FREE) break;
+					names->slots[slot] = members[placed];
+				}
+				if(placed==members_count) break;
+				// откат частично размещённой корзины
+				for(uint8_t k=0; k<placed; k++)
+					names->slots[GOFSM_Names_Slot(hashes[members[k]], displacement, count)] = GOFSM_NAMES_SLOT_FREE;
+			}
+			if(displacement>GOFSM_NAMES_DISPLACEMENT_LIMIT)
+				return 0;
+			names->buckets[b] = displacement;
+		}
+	}
+	return 1;
+}
+
+// Совпадающие имена не разделит никакая соль: проверка до перебора солей.
+// Строки читаются один раз, попарно сравниваются хеши, strcmp — только при совпадении хешей
+static uint8_t GOFSM_Names_HasDuplicates(const GOFSM_Names_t* names){
+	uint32_t hashes[UINT8_MAX];
+	for(uint8_t i=0; i<names->names_count; i++){
+		hashes[i] = GOFSM_Names_Hash(names->names[i], 0);
+		for(uint8_t k=0; k<i; k++)
+			if(hashes[k]==hashes[i] && strcmp(names->names[k], names->names[i])==0)
+				return 1;
+	}
+	return 0;
+}
+
+GOFSM_Error_t GOFSM_Names_InitStatic(GOFSM_Names_t* names){
+	GOFSM_ASSERT(names!=NULL);
+	GOFSM_ASSERT(names->names!=NULL);
+	GOFSM_ASSERT(names->buckets!=NULL);
+	GOFSM_ASSERT(names->slots!=NULL);
+	if(names->names_count==0)
+		return GOFSM_Error_No;
+	if(!GOFSM_Names_HasDuplicates(names)){
+		// при неудачном наборе хешей меняем соль
+		for(uint16_t salt=0; salt<=GOFSM_NAMES_SALT_LIMIT; salt++){
+			names->salt = salt;
+			if(GOFSM_Names_TryBuild(names))
+				return GOFSM_Error_No;
+		}
+	}
+	// таблица без хеш-функции пуста: Find отвечает UnknownName, Get — NULL
+	names->names_count = 0;
+	return GOFSM_Error_NamesCollision;
+}
+
+GOFSM_Error_t GOFSM_Names_Init(GOFSM_Names_t* names, const char* const* names_array, uint8_t names_count){
+	names->is_dyn = 1;
+
+	names->names = names_array;
+	names->names_count = names_count;
+	names->buckets_count = GOFSM_NAMES_BUCKETS(names_count);
+
+	names->buckets = (uint16_t*)malloc(names->buckets_count * sizeof(uint16_t));
+	names->slots = (GOFSM_Node_Index_t*)malloc((names_count ? names_count : 1) * sizeof(GOFSM_Node_Index_t));
+
+	return GOFSM_Names_InitStatic(names);
+}
+void GOFSM_Names_Deinit(GOFSM_Names_t* names){
+	if(!names->is_dyn) return;
+	free(names->buckets);
+	free(names->slots);
+	names->buckets = NULL;
+	names->slots = NULL;
+	names->is_dyn = 0;
+}
+
+GOFSM_Error_t GOFSM_Names_Find(const GOFSM_Names_t* names, const char* name, GOFSM_Node_Index_t* node_index){
+	GOFSM_ASSERT(names!=NULL);
+	GOFSM_ASSERT(name!=NULL);
+	if(names->names_count==0)
+		return GOFSM_Error_UnknownName;
+
+	uint32_t hash = GOFSM_Names_Hash(name, names->salt);
+	uint16_t displacement = names->buckets[hash % names->buckets_count];
+	GOFSM_Node_Index_t index = names->slots[GOFSM_Names_Slot(hash, displacement, names->names_count)];
+
+	// хеш совершенный только на известном множестве имён, чужое имя надо отсечь
+	if(strcmp(names->names[index], name)!=0)
+		return GOFSM_Error_UnknownName;
+	*node_index = index;
+	return GOFSM_Error_No;
+}
+const char* GOFSM_Names_Get(const GOFSM_Names_t* names, GOFSM_Node_Index_t node_index){
+	GOFSM_ASSERT(names!=NULL);
+	if(node_index>=names->names_count)
+		return NULL;
+	return names->names[node_index];
+}
+
+GOFSM_Error_t GOFSM_SetTargetByName(GOFSM_t* gofsm, const GOFSM_Names_t* names, const char* name){
+	GOFSM_Node_Index_t node_index;
+	GOFSM_Error_t error = GOFSM_Names_Find(names, name, &node_index);
+	if(error!=GOFSM_Error_No)
+		return error;
+	GOFSM_SetTarget(gofsm, node_index);
+	return GOFSM_Error_No;
+}
@@ -0,0 +1,56 @@
+#ifndef GOFSM_NAMES_H
+#define GOFSM_NAMES_H
+
+#include <GOFSM/gofsm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Таблица имён нод графа.
+// names[i] — имя ноды с индексом i. Поиск индекса по имени выполняется через
+// минимальную совершенную хеш-функцию (hash and displace), которая строится один раз
+// при инициализации таблицы. Поиск: один проход по строке + одно сравнение strcmp.
+typedef struct __attribute__((packed)){
+	const char* const* names;
+	uint8_t names_count;
+	uint8_t buckets_count;
+	uint8_t salt;
+	uint16_t* buckets;
+	GOFSM_Node_Index_t* slots;
+	uint8_t is_dyn;
+}GOFSM_Names_t;
+
+#define GOFSM_NAMES_BUCKETS(NCOUNT) ((NCOUNT)/2+1)
+
+#define GOFSM_NAMES_STATIC_ALLOCATE(STORAGE, name, NAMES, NCOUNT)        \
+	STORAGE uint16_t name##_buckets[GOFSM_NAMES_BUCKETS(NCOUNT)];          \
+	STORAGE GOFSM_Node_Index_t name##_slots[NCOUNT];                       \
+	STORAGE GOFSM_Names_t name = {                                         \
+		.names         = (NAMES),                                          \
+		.names_count   = (NCOUNT),                                         \
+		.buckets_count = GOFSM_NAMES_BUCKETS(NCOUNT),                      \
+		.buckets       = name##_buckets,                                   \
+		.slots         = name##_slots                                      \
+	}
+
+// Использовать строго для таблиц созданных через GOFSM_NAMES_STATIC_ALLOCATE().
+// GOFSM_Error_NamesCollision — совпадающие имена или хеш-функция не построена; таблица остаётся пустой
+GOFSM_Error_t GOFSM_Names_InitStatic(GOFSM_Names_t* names);
+
+// Динамическая инициализация. Массив имён не копируется и должен жить дольше таблицы
+GOFSM_Error_t GOFSM_Names_Init(GOFSM_Names_t* names, const char* const* names_array, uint8_t names_count);
+void GOFSM_Names_Deinit(GOFSM_Names_t* names);
+
+GOFSM_Error_t GOFSM_Names_Find(const GOFSM_Names_t* names, const char* name, GOFSM_Node_Index_t* node_index);
+const char* GOFSM_Names_Get(const GOFSM_Names_t* names, GOFSM_Node_Index_t node_index);
+
+// Индекс из таблицы назначается как есть. После GOFSM_Renumber_Apply() он пользовательский,
+// поэтому цель по имени ставится через GOFSM_Names_Find и GOFSM_Renumber_SetTarget
+GOFSM_Error_t GOFSM_SetTargetByName(GOFSM_t* gofsm, const GOFSM_Names_t* names, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+#include <GOFSM/gofsm_pool.h>
+
+static void* GOFSM_Pool_Worker(void* argument){
+	GOFSM_Pool_t* pool = (GOFSM_Pool_t*)argument;
+	pthread_mutex_lock(&pool->mutex);
+	for(;;){
+		while(pool->queue_count==0 && !pool->is_stopping)
+			pthread_cond_wait(&pool->cond, &pool->mutex);
+		if(pool->is_stopping) break;
+		GOFSM_Transition_Async_t* job = pool->queue[pool->queue_head];
+		pool->queue_head = (uint16_t)((pool->queue_head+1) % pool->queue_capacity);
+		pool->queue_count--;
+		__atomic_store_n(&job->status, GOFSM_Async_Running, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&pool->mutex);
+
+		GOFSM_Transition_Result_t result = GOFSM_Transition_Result_Success;
+		if(job->function!=NULL)
+			result = job->function(&job->transition);
+		job->result = (uint8_t)result;
+		// release: результат виден потоку тиков раньше статуса Done
+		__atomic_store_n(&job->status, GOFSM_Async_Done, __ATOMIC_RELEASE);
+		if(pool->notify!=NULL)
+			pool->notify(pool->notify_context);
+
+		pthread_mutex_lock(&pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+// Поток тиков: постановка без ожидания мьютекса
+static uint8_t GOFSM_Pool_TrySubmit(GOFSM_Pool_t* pool, GOFSM_Transition_Async_t* job){
+	if(pthread_mutex_trylock(&pool->mutex)!=0)
+		return 0;
+	uint8_t is_submitted = 0;
+	if(pool->queue_count<pool->queue_capacity && !pool->is_stopping){
+		pool->queue[(pool->queue_head+pool->queue_count) % pool->queue_capacity] = job;
+		pool->queue_count++;
+		__atomic_store_n(&job->status, GOFSM_Async_Queued, __ATOMIC_RELAXED);
+		pthread_cond_signal(&pool->cond);
+		is_submitted = 1;
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return is_submitted;
+}
+
+static GOFSM_Transition_Result_t GOFSM_Async_Function(GOFSM_Transition_t* transition){
+	GOFSM_Transition_Async_t* async = (GOFSM_Transition_Async_t*)transition;
+	uint32_t invocation = async->gofsm->stats.invocations;
+	// предыдущий вызов у автомата был вызовом этого же перехода
+	uint8_t is_continued = async->invocation+1==invocation;
+	async->invocation = invocation;
+	switch(__atomic_load_n(&async->status, __ATOMIC_ACQUIRE)){
+		case GOFSM_Async_Done:
+			__atomic_store_n(&async->status, GOFSM_Async_Idle, __ATOMIC_RELAXED);
+			if(is_continued && !async->is_abandoned)
+				return (GOFSM_Transition_Result_t)async->result;
+			// результат относится к прежнему выбору перехода: задание выполняется заново
+			async->is_abandoned = 0;
+			GOFSM_Pool_TrySubmit(async->pool, async);
+			return GOFSM_Transition_Result_Failure;
+		case GOFSM_Async_Idle:
+			async->is_abandoned = 0;
+			GOFSM_Pool_TrySubmit(async->pool, async);
+			return GOFSM_Transition_Result_Failure;
+		default:
+			if(!is_continued)
+				async->is_abandoned = 1;
+			return GOFSM_Transition_Result_Failure;
+	}
+}
+
+void GOFSM_Transition_InitAsync(GOFSM_Transition_Async_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function, GOFSM_Pool_t* pool, GOFSM_t* gofsm){
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_ASSERT(pool!=NULL);
+	GOFSM_ASSERT(gofsm!=NULL);
+	GOFSM_Transition_Init(&transition->transition, source_node_index, destination_node_index, GOFSM_Async_Function);
+	transition->function = function;
+	transition->pool = pool;
+	transition->gofsm = gofsm;
+	transition->invocation = 0;
+	transition->is_abandoned = 0;
+	transition->result = GOFSM_Transition_Result_Failure;
+	__atomic_store_n(&transition->status, GOFSM_Async_Idle, __ATOMIC_RELAXED);
+}
+
+// Останавливает запущенные потоки и освобождает мьютекс и условную переменную, буферы не трогает
+static void GOFSM_Pool_Stop(GOFSM_Pool_t* pool){
+	pthread_mutex_lock(&pool->mutex);
+	pool->is_stopping = 1;
+	// не начатые задания возвращаются в исходное состояние
+	for(uint16_t i=0; i<pool->queue_count; i++)
+		__atomic_store_n(&pool->queue[(pool->queue_head+i) % pool->queue_capacity]->status, GOFSM_Async_Idle, __ATOMIC_RELAXED);
+	pool->queue_count = 0;
+	pthread_cond_broadcast(&pool->cond);
+	pthread_mutex_unlock(&pool->mutex);
+	for(uint8_t i=0; i<pool->threads_started; i++)
+		pthread_join(pool->threads[i], NULL);
+	pool->threads_started = 0;
+	pthread_cond_destroy(&pool->cond);
+	pthread_mutex_destroy(&pool->mutex);
+	pool->is_running = 0;
+}
+
+GOFSM_Error_t GOFSM_Pool_InitStatic(GOFSM_Pool_t* pool){
+	GOFSM_ASSERT(pool!=NULL);
+	GOFSM_ASSERT(pool->threads!=NULL);
+	GOFSM_ASSERT(pool->queue!=NULL);
+	GOFSM_ASSERT(pool->queue_capacity!=0);
+	pool->queue_head = 0;
+	pool->queue_count = 0;
+	pool->threads_started = 0;
+	pool->is_stopping = 0;
+	pool->notify = NULL;
+	pool->notify_context = NULL;
+	pool->is_running = 0;
+	if(pthread_mutex_init(&pool->mutex, NULL)!=0)
+		return GOFSM_Error_ThreadStart;
+	if(pthread_cond_init(&pool->cond, NULL)!=0){
+		pthread_mutex_destroy(&pool->mutex);
+		return GOFSM_Error_ThreadStart;
+	}
+	pool->is_running = 1;
+	for(; pool->threads_started<pool->threads_count; pool->threads_started++)
+		if(pthread_create(pool->threads+pool->threads_started, NULL, GOFSM_Pool_Worker, pool)!=0){
+			// буферы остаются за вызывающим: их освобождает последующий GOFSM_Pool_Deinit
+			GOFSM_Pool_Stop(pool);
+			return GOFSM_Error_ThreadStart;
+		}
+	return GOFSM_Error_No;
+}
+GOFSM_Error_t GOFSM_Pool_Init(GOFSM_Pool_t* pool, uint8_t threads_count, uint16_t queue_capacity){
+	pool->is_dyn = 1;
+
+	pool->threads_count = threads_count;
+	pool->queue_capacity = queue_capacity;
+
+	pool->threads = (pthread_t*)malloc(threads_count * sizeof(pthread_t));
+	pool->queue = (GOFSM_Transition_Async_t**)malloc(queue_capacity * sizeof(GOFSM_Transition_Async_t*));
+
+	return GOFSM_Pool_InitStatic(pool);
+}
+void GOFSM_Pool_SetNotify(GOFSM_Pool_t* pool, GOFSM_Pool_Notify_t notify, void* context){
+	GOFSM_ASSERT(pool!=NULL);
+	pool->notify_context = context;
+	pool->notify = notify;
+}
+
+void GOFSM_Pool_Deinit(GOFSM_Pool_t* pool){
+	// пул, не запустившийся в Init, уже остановлен
+	if(pool->is_running)
+		GOFSM_Pool_Stop(pool);
+
+	if(!pool->is_dyn) return;
+	free(pool->threads);
+	free(pool->queue);
+	pool->threads = NULL;
+	pool->queue = NULL;
+	pool->is_dyn = 0;
+}
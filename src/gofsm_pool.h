@@ -0,0 +1,96 @@
+#ifndef GOFSM_POOL_H
+#define GOFSM_POOL_H
+
+#include <GOFSM/gofsm.h>
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Пул рабочих потоков для блокирующих функций переходов (запись файлов, ioctl и т.п.).
+// Переход с политикой Async не выполняет функцию в потоке тиков: первый вызов ставит задание
+// в ограниченную очередь пула и возвращает Failure, пока задание в работе переход повторяется
+// как ожидающий, результат забирается на одном из следующих тиков.
+// Поток тиков не блокируется: постановка берёт мьютекс очереди через trylock (занят или очередь
+// полна — повтор на следующем тике), готовность читается атомарно без блокировок.
+typedef enum{
+	GOFSM_Async_Idle = 0,
+	GOFSM_Async_Queued = 1,
+	GOFSM_Async_Running = 2,
+	GOFSM_Async_Done = 3
+}GOFSM_Async_Status_t;
+
+// Уведомление о готовом результате, вызывается в рабочем потоке
+typedef void (*GOFSM_Pool_Notify_t)(void* context);
+
+struct GOFSM_Pool_t;
+typedef struct __attribute__((packed)){
+	GOFSM_Transition_t transition;
+	GOFSM_Transition_Function_t function;   // выполняется в рабочем потоке
+	struct GOFSM_Pool_t* pool;
+	GOFSM_t* gofsm;                         // автомат, в котором переход зарегистрирован
+	uint32_t invocation;                    // stats.invocations автомата при последнем вызове перехода
+	uint8_t is_abandoned;                   // автомат уходил с перехода, пока задание было в работе
+	uint8_t status;                         // GOFSM_Async_Status_t, доступ только атомарный
+	uint8_t result;                         // GOFSM_Transition_Result_t, публикуется записью status==Done
+}GOFSM_Transition_Async_t;
+
+// Не упакована: мьютекс и условная переменная требуют естественного выравнивания
+typedef struct GOFSM_Pool_t{
+	uint8_t threads_count;
+	uint8_t threads_started;
+	uint16_t queue_capacity;
+	uint16_t queue_head;
+	uint16_t queue_count;
+	pthread_t* threads;
+	GOFSM_Transition_Async_t** queue;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	GOFSM_Pool_Notify_t notify;       // NULL — поток тиков сам замечает готовность на следующем тике
+	void* notify_context;
+	uint8_t is_stopping;
+	uint8_t is_running;               // мьютекс и условная переменная созданы, потоки не остановлены
+	uint8_t is_dyn;
+}GOFSM_Pool_t;
+
+#define GOFSM_POOL_STATIC_ALLOCATE(STORAGE, name, THREADS, QCOUNT)          \
+	STORAGE pthread_t name##_threads[THREADS];                                \
+	STORAGE GOFSM_Transition_Async_t* name##_queue[QCOUNT];                   \
+	STORAGE GOFSM_Pool_t name = {                                             \
+		.threads_count  = (THREADS),                                          \
+		.queue_capacity = (QCOUNT),                                           \
+		.threads        = name##_threads,                                     \
+		.queue          = name##_queue                                        \
+	}
+
+// Использовать строго для пулов созданных через GOFSM_POOL_STATIC_ALLOCATE().
+// Запускает потоки; GOFSM_Error_ThreadStart — не созданы мьютекс, условная переменная или поток,
+// созданное уже освобождено, пулом пользоваться нельзя, GOFSM_Pool_Deinit() только освобождает
+// буферы динамического пула
+GOFSM_Error_t GOFSM_Pool_InitStatic(GOFSM_Pool_t* pool);
+GOFSM_Error_t GOFSM_Pool_Init(GOFSM_Pool_t* pool, uint8_t threads_count, uint16_t queue_capacity);
+// Останавливает и дожидается потоков (в том числе у статического пула).
+// Выполняемые задания завершаются, ещё не начатые снимаются и повторятся при следующем вызове перехода
+void GOFSM_Pool_Deinit(GOFSM_Pool_t* pool);
+
+// Вызов notify(context) после публикации каждого результата, например чтобы разбудить цикл событий
+// (GOFSM_Loop_AttachPool). Задаётся после запуска пула и до постановки заданий
+void GOFSM_Pool_SetNotify(GOFSM_Pool_t* pool, GOFSM_Pool_Notify_t notify, void* context);
+
+// Регистрируется как обычный переход: GOFSM_AddTransition(gofsm, &async->transition).
+// Готовый результат применяется, только если переход оставался текущим у gofsm всё время работы
+// задания. Если автомат за это время выполнял другие переходы, результат отбрасывается,
+// и при следующем вызове задание ставится заново
+void GOFSM_Transition_InitAsync(GOFSM_Transition_Async_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function, GOFSM_Pool_t* pool, GOFSM_t* gofsm);
+
+static inline GOFSM_Async_Status_t GOFSM_Transition_GetAsyncStatus(const GOFSM_Transition_Async_t* transition){
+	return (GOFSM_Async_Status_t)__atomic_load_n(&transition->status, __ATOMIC_ACQUIRE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
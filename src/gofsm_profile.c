@@ -0,0 +1,160 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE     // clock_gettime
+#endif
+
+#include <GOFSM/gofsm_profile.h>
+
+#include <time.h>
+
+static __thread GOFSM_Profile_t* GOFSM_Profile_Local = NULL;
+
+static inline uint32_t GOFSM_Histogram_Index(uint32_t value){
+	if(value<GOFSM_HISTOGRAM_SUB_COUNT)
+		return value;
+	uint32_t shift = (uint32_t)(31-__builtin_clz(value))-GOFSM_HISTOGRAM_SUB_BITS;
+	return (shift+1)*GOFSM_HISTOGRAM_SUB_COUNT + (value>>shift) - GOFSM_HISTOGRAM_SUB_COUNT;
+}
+
+// Наибольшее значение, попадающее в поддиапазон index
+static inline uint32_t GOFSM_Histogram_Upper(uint32_t index){
+	if(index<2*GOFSM_HISTOGRAM_SUB_COUNT)
+		return index;
+	uint32_t shift = index/GOFSM_HISTOGRAM_SUB_COUNT-1;
+	uint32_t lower = (index%GOFSM_HISTOGRAM_SUB_COUNT+GOFSM_HISTOGRAM_SUB_COUNT)<<shift;
+	return lower+((1u<<shift)-1);
+}
+
+void GOFSM_Histogram_Reset(GOFSM_Histogram_t* histogram){
+	GOFSM_ASSERT(histogram!=NULL);
+	memset(histogram, 0, sizeof(*histogram));
+}
+
+void GOFSM_Histogram_Record(GOFSM_Histogram_t* histogram, uint32_t value){
+	uint32_t* count = histogram->counts+GOFSM_Histogram_Index(value);
+	// единственный писатель: атомарная запись без read-modify-write, читатели видят целые значения
+	__atomic_store_n(count, *count+1, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram->total, histogram->total+1, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram->sum, histogram->sum+value, __ATOMIC_RELAXED);
+	if(value>histogram->max)
+		__atomic_store_n(&histogram->max, value, __ATOMIC_RELAXED);
+}
+
+void GOFSM_Histogram_Merge(GOFSM_Histogram_t* destination, const GOFSM_Histogram_t* source){
+	GOFSM_ASSERT(destination!=NULL);
+	GOFSM_ASSERT(source!=NULL);
+	for(uint32_t i=0; i<GOFSM_HISTOGRAM_BUCKETS; i++){
+		uint32_t count = __atomic_load_n(source->counts+i, __ATOMIC_RELAXED);
+		if(count!=0)
+			__atomic_fetch_add(destination->counts+i, count, __ATOMIC_RELAXED);
+	}
+	__atomic_fetch_add(&destination->total, __atomic_load_n(&source->total, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+	__atomic_fetch_add(&destination->sum, __atomic_load_n(&source->sum, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+	uint32_t max = __atomic_load_n(&source->max, __ATOMIC_RELAXED);
+	uint32_t seen = __atomic_load_n(&destination->max, __ATOMIC_RELAXED);
+	while(max>seen && !__atomic_compare_exchange_n(&destination->max, &seen, max, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+uint32_t GOFSM_Histogram_Percentile(const GOFSM_Histogram_t* histogram, uint16_t percentile_x100){
+	GOFSM_ASSERT(histogram!=NULL);
+	GOFSM_ASSERT(percentile_x100<=10000);
+	// итог пересчитывается по корзинам: при одновременной записи total может опережать счётчики
+	uint64_t total = 0;
+	for(uint32_t i=0; i<GOFSM_HISTOGRAM_BUCKETS; i++)
+		total += __atomic_load_n(histogram->counts+i, __ATOMIC_RELAXED);
+	if(total==0)
+		return 0;
+	uint64_t rank = (total*percentile_x100+9999)/10000;
+	if(rank==0) rank = 1;
+	uint64_t seen = 0;
+	uint32_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+	for(uint32_t i=0; i<GOFSM_HISTOGRAM_BUCKETS; i++){
+		seen += __atomic_load_n(histogram->counts+i, __ATOMIC_RELAXED);
+		if(seen>=rank){
+			uint32_t upper = GOFSM_Histogram_Upper(i);
+			return upper<max ? upper : max;
+		}
+	}
+	return max;
+}
+
+uint64_t GOFSM_Histogram_Count(const GOFSM_Histogram_t* histogram){
+	return __atomic_load_n(&histogram->total, __ATOMIC_RELAXED);
+}
+
+uint32_t GOFSM_Histogram_Mean(const GOFSM_Histogram_t* histogram){
+	uint64_t total = __atomic_load_n(&histogram->total, __ATOMIC_RELAXED);
+	if(total==0)
+		return 0;
+	return (uint32_t)(__atomic_load_n(&histogram->sum, __ATOMIC_RELAXED)/total);
+}
+
+void GOFSM_Profile_Reset(GOFSM_Profile_t* profile){
+	GOFSM_ASSERT(profile!=NULL);
+	memset(profile, 0, sizeof(*profile));
+}
+
+// Запись таблицы функций для function. При is_insert свободная запись занимается через CAS,
+// поэтому сливать в одну сводную могут несколько потоков. NULL — функции нет или таблица полна
+static GOFSM_Profile_Function_t* GOFSM_Profile_Find(GOFSM_Profile_Function_t* functions, GOFSM_Transition_Function_t function, uint8_t is_insert){
+	uint32_t start = (uint32_t)(((uintptr_t)function >> 2) * 0x9E3779B1u) % GOFSM_PROFILE_FUNCTIONS;
+	for(uint32_t i=0; i<GOFSM_PROFILE_FUNCTIONS; i++){
+		GOFSM_Profile_Function_t* entry = functions+(start+i) % GOFSM_PROFILE_FUNCTIONS;
+		GOFSM_Transition_Function_t key = __atomic_load_n(&entry->function, __ATOMIC_ACQUIRE);
+		if(key==function)
+			return entry;
+		if(key!=NULL)
+			continue;
+		if(!is_insert)
+			return NULL;
+		GOFSM_Transition_Function_t expected = NULL;
+		// проигравший CAS видит ключ победителя: это либо та же функция, либо запись занята
+		if(__atomic_compare_exchange_n(&entry->function, &expected, function, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+			|| expected==function)
+			return entry;
+	}
+	return NULL;
+}
+
+void GOFSM_Profile_RecordFunction(GOFSM_Profile_t* profile, GOFSM_Transition_Function_t function, uint32_t value){
+	GOFSM_Profile_Function_t* entry = GOFSM_Profile_Find(profile->functions, function, 1);
+	if(entry!=NULL)
+		GOFSM_Histogram_Record(&entry->histogram, value);
+	else
+		__atomic_store_n(&profile->functions_dropped, profile->functions_dropped+1, __ATOMIC_RELAXED);
+}
+
+const GOFSM_Histogram_t* GOFSM_Profile_Function(const GOFSM_Profile_t* profile, GOFSM_Transition_Function_t function){
+	GOFSM_ASSERT(profile!=NULL);
+	GOFSM_Profile_Function_t* entry = GOFSM_Profile_Find((GOFSM_Profile_Function_t*)profile->functions, function, 0);
+	return entry!=NULL ? &entry->histogram : NULL;
+}
+
+void GOFSM_Profile_Merge(GOFSM_Profile_t* destination, const GOFSM_Profile_t* source){
+	GOFSM_Histogram_Merge(&destination->tick, &source->tick);
+	GOFSM_Histogram_Merge(&destination->plan, &source->plan);
+	GOFSM_Histogram_Merge(&destination->function, &source->function);
+	for(uint32_t i=0; i<GOFSM_PROFILE_FUNCTIONS; i++){
+		GOFSM_Transition_Function_t function = __atomic_load_n(&source->functions[i].function, __ATOMIC_ACQUIRE);
+		if(function==NULL) continue;
+		GOFSM_Profile_Function_t* entry = GOFSM_Profile_Find(destination->functions, function, 1);
+		if(entry!=NULL)
+			GOFSM_Histogram_Merge(&entry->histogram, &source->functions[i].histogram);
+		else
+			__atomic_fetch_add(&destination->functions_dropped, GOFSM_Histogram_Count(&source->functions[i].histogram), __ATOMIC_RELAXED);
+	}
+	__atomic_fetch_add(&destination->functions_dropped, __atomic_load_n(&source->functions_dropped, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void GOFSM_Profile_Attach(GOFSM_Profile_t* profile){
+	GOFSM_Profile_Local = profile;
+}
+
+GOFSM_Profile_t* GOFSM_Profile_Current(void){
+	return GOFSM_Profile_Local;
+}
+
+uint32_t GOFSM_Profile_Clock(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec*1000000000ull+(uint64_t)now.tv_nsec);
+}
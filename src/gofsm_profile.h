@@ -0,0 +1,86 @@
+#ifndef GOFSM_PROFILE_H
+#define GOFSM_PROFILE_H
+
+#include <GOFSM/gofsm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Гистограммы длительностей с большим динамическим диапазоном (по образцу HDR):
+// значение раскладывается на степень двойки и 2^GOFSM_HISTOGRAM_SUB_BITS линейных поддиапазонов,
+// относительная погрешность не больше 2^-GOFSM_HISTOGRAM_SUB_BITS во всём диапазоне uint32_t.
+// Запись без блокировок и без атомарных сложений: у каждого потока своя гистограмма,
+// сводная собирается GOFSM_Histogram_Merge, которое можно вызывать из любого числа потоков
+#ifndef GOFSM_HISTOGRAM_SUB_BITS
+#define GOFSM_HISTOGRAM_SUB_BITS 5
+#endif
+#define GOFSM_HISTOGRAM_SUB_COUNT (1u<<GOFSM_HISTOGRAM_SUB_BITS)
+#define GOFSM_HISTOGRAM_BUCKETS   ((33u-GOFSM_HISTOGRAM_SUB_BITS)*GOFSM_HISTOGRAM_SUB_COUNT)
+
+// Источник времени для замеров ядра (единицы произвольные, например такты DWT->CYCCNT).
+// По умолчанию — наносекунды CLOCK_MONOTONIC
+#ifndef GOFSM_PROFILE_CLOCK
+#define GOFSM_PROFILE_CLOCK() GOFSM_Profile_Clock()
+#endif
+
+// Не упакована: счётчики читаются и складываются атомарно и требуют естественного выравнивания
+typedef struct{
+	uint32_t counts[GOFSM_HISTOGRAM_BUCKETS];
+	uint64_t total;                   // число записей
+	uint64_t sum;                     // сумма значений, для среднего
+	uint32_t max;
+}GOFSM_Histogram_t;
+
+// Число функций переходов с отдельной гистограммой в профиле
+#ifndef GOFSM_PROFILE_FUNCTIONS
+#define GOFSM_PROFILE_FUNCTIONS 16
+#endif
+
+// Гистограмма одной функции перехода. Ключ — указатель на функцию, а не на переход:
+// он одинаков у всех автоматов и клонов, поэтому профили разных экземпляров сливаются по нему
+typedef struct{
+	GOFSM_Transition_Function_t function;   // NULL — запись свободна; занимается один раз, доступ атомарный
+	GOFSM_Histogram_t histogram;
+}GOFSM_Profile_Function_t;
+
+// Замеры ядра при сборке с GOFSM_PROFILE_ENABLED
+typedef struct{
+	GOFSM_Histogram_t tick;           // GOFSM_OnTick целиком
+	GOFSM_Histogram_t plan;           // поиск следующего шага
+	GOFSM_Histogram_t function;       // функции переходов, все вместе
+	GOFSM_Profile_Function_t functions[GOFSM_PROFILE_FUNCTIONS];   // по функциям, открытая адресация
+	uint64_t functions_dropped;       // замеры функций, не поместившихся в таблицу (есть только в function)
+}GOFSM_Profile_t;
+
+void GOFSM_Histogram_Reset(GOFSM_Histogram_t* histogram);
+// Запись из одного потока-владельца. Чтение и слияние из других потоков допустимы одновременно с записью
+void GOFSM_Histogram_Record(GOFSM_Histogram_t* histogram, uint32_t value);
+// Прибавляет source к destination атомарными сложениями: несколько потоков сливают в одну сводную
+void GOFSM_Histogram_Merge(GOFSM_Histogram_t* destination, const GOFSM_Histogram_t* source);
+// Значение, не превышаемое долей percentile_x100/10000 записей (9900 — p99, 9990 — p99.9).
+// Возвращается верхняя граница поддиапазона, 0 — записей нет
+uint32_t GOFSM_Histogram_Percentile(const GOFSM_Histogram_t* histogram, uint16_t percentile_x100);
+uint64_t GOFSM_Histogram_Count(const GOFSM_Histogram_t* histogram);
+uint32_t GOFSM_Histogram_Mean(const GOFSM_Histogram_t* histogram);
+
+void GOFSM_Profile_Reset(GOFSM_Profile_t* profile);
+// Слияние по всем гистограммам, гистограммы функций сопоставляются по указателю на функцию
+void GOFSM_Profile_Merge(GOFSM_Profile_t* destination, const GOFSM_Profile_t* source);
+// Запись замера функции перехода, из потока-владельца профиля
+void GOFSM_Profile_RecordFunction(GOFSM_Profile_t* profile, GOFSM_Transition_Function_t function, uint32_t value);
+// Гистограмма функции перехода, NULL — замеров этой функции нет
+const GOFSM_Histogram_t* GOFSM_Profile_Function(const GOFSM_Profile_t* profile, GOFSM_Transition_Function_t function);
+
+// Профиль, в который ядро пишет замеры автоматов, тикаемых текущим потоком (NULL — не писать).
+// Назначается один раз при старте каждого потока тиков
+void GOFSM_Profile_Attach(GOFSM_Profile_t* profile);
+GOFSM_Profile_t* GOFSM_Profile_Current(void);
+
+uint32_t GOFSM_Profile_Clock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+#include <GOFSM/gofsm_renumber.h>
+
+#define GOFSM_RENUMBER_NODES (UINT8_MAX+1)
+
+static void GOFSM_Renumber_Assign(GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index){
+	renumber->to_internal[node_index] = renumber->nodes_count;
+	renumber->to_external[renumber->nodes_count] = node_index;
+	renumber->nodes_count++;
+}
+
+// Обход в ширину компоненты от start по неориентированным рёбрам.
+// Для RCM соседи ставятся в очередь по возрастанию степени.
+// Очередью служит to_external: порядок обхода и есть новая нумерация
+static void GOFSM_Renumber_Visit(GOFSM_Renumber_t* renumber, const GOFSM_t* gofsm, const uint16_t* degree, uint8_t by_degree, GOFSM_Node_Index_t start){
+	uint16_t head = renumber->nodes_count;
+	GOFSM_Renumber_Assign(renumber, start);
+	while(head<renumber->nodes_count){
+		GOFSM_Node_Index_t node = renumber->to_external[head++];
+		uint16_t first = renumber->nodes_count;
+		for(uint8_t j=0; j<gofsm->transitions_count; j++){
+			const GOFSM_Transition_t* transition = gofsm->transitions[j];
+			GOFSM_Node_Index_t neighbour;
+			if(transition->is_any)
+				continue;
+			if(transition->source_node_index==node)
+				neighbour = transition->destination_node_index;
+			else if(transition->destination_node_index==node)
+				neighbour = transition->source_node_index;
+			else
+				continue;
+			if(renumber->to_internal[neighbour]!=GOFSM_RENUMBER_NONE) continue;
+			GOFSM_Renumber_Assign(renumber, neighbour);
+		}
+		if(!by_degree) continue;
+		// сортировка вставками только что добавленных соседей по степени
+		for(uint16_t i=first+1; i<renumber->nodes_count; i++){
+			GOFSM_Node_Index_t key = renumber->to_external[i];
+			uint16_t k = i;
+			while(k>first && degree[renumber->to_external[k-1]]>degree[key]){
+				renumber->to_external[k] = renumber->to_external[k-1];
+				k--;
+			}
+			renumber->to_external[k] = key;
+		}
+		for(uint16_t i=first; i<renumber->nodes_count; i++)
+			renumber->to_internal[renumber->to_external[i]] = i;
+	}
+}
+
+GOFSM_Error_t GOFSM_Renumber_Build(GOFSM_Renumber_t* renumber, const GOFSM_t* gofsm, GOFSM_Renumber_Order_t order, GOFSM_Node_Index_t root){
+	GOFSM_ASSERT(renumber!=NULL);
+	GOFSM_ASSERT(gofsm!=NULL);
+	uint16_t degree[GOFSM_RENUMBER_NODES] = {0};
+	uint8_t is_used[GOFSM_RENUMBER_NODES] = {0};
+
+	memset(renumber->to_internal, GOFSM_RENUMBER_NONE, sizeof(renumber->to_internal));
+	memset(renumber->to_external, GOFSM_RENUMBER_NONE, sizeof(renumber->to_external));
+	renumber->nodes_count = 0;
+
+	uint16_t used_count = 0;
+	for(uint8_t j=0; j<gofsm->transitions_count; j++){
+		const GOFSM_Transition_t* transition = gofsm->transitions[j];
+		degree[transition->destination_node_index]++;
+		is_used[transition->destination_node_index] = 1;
+		if(transition->is_any){
+			// множество источников задано в пользовательских индексах и не переписывается
+			if(((const GOFSM_Transition_Any_t*)transition)->source_set!=NULL)
+				return GOFSM_Error_Unsupported;
+			continue;
+		}
+		degree[transition->source_node_index]++;
+		is_used[transition->source_node_index] = 1;
+	}
+	is_used[gofsm->current_node_index] = 1;
+	is_used[gofsm->target_node_index] = 1;
+	uint8_t has_any = 0;
+	for(uint8_t j=0; j<gofsm->transitions_count; j++)
+		has_any |= gofsm->transitions[j]->is_any;
+	for(uint16_t node=0; node<GOFSM_RENUMBER_NODES; node++){
+		used_count += is_used[node];
+		// wildcard без множества покрывает ноды ниже nodes_capacity: после перенумерации
+		// источником стала бы и нода, которая им не была
+		if(has_any && is_used[node] && node>=gofsm->nodes_capacity)
+			return GOFSM_Error_Unsupported;
+	}
+	// внутренний индекс 0xFF зарезервирован под "нет ноды"
+	if(used_count>gofsm->nodes_capacity || used_count>=GOFSM_RENUMBER_NODES)
+		return GOFSM_Error_OwerstackNodes;
+
+	if(order==GOFSM_Renumber_Order_Bfs && is_used[root])
+		GOFSM_Renumber_Visit(renumber, gofsm, degree, 0, root);
+
+	while(renumber->nodes_count<used_count){
+		// следующая компонента: для RCM — с ноды минимальной степени
+		uint16_t start = GOFSM_RENUMBER_NODES;
+		for(uint16_t node=0; node<GOFSM_RENUMBER_NODES; node++){
+			if(!is_used[node] || renumber->to_internal[node]!=GOFSM_RENUMBER_NONE) continue;
+			if(start==GOFSM_RENUMBER_NODES || (order==GOFSM_Renumber_Order_Rcm && degree[node]<degree[start]))
+				start = node;
+			if(order!=GOFSM_Renumber_Order_Rcm) break;
+		}
+		GOFSM_Renumber_Visit(renumber, gofsm, degree, order==GOFSM_Renumber_Order_Rcm, (GOFSM_Node_Index_t)start);
+	}
+
+	if(order==GOFSM_Renumber_Order_Rcm){
+		for(uint16_t i=0; i<renumber->nodes_count/2; i++){
+			GOFSM_Node_Index_t swap = renumber->to_external[i];
+			renumber->to_external[i] = renumber->to_external[renumber->nodes_count-1-i];
+			renumber->to_external[renumber->nodes_count-1-i] = swap;
+		}
+		for(uint16_t i=0; i<renumber->nodes_count; i++)
+			renumber->to_internal[renumber->to_external[i]] = i;
+	}
+	return GOFSM_Error_No;
+}
+
+void GOFSM_Renumber_Apply(const GOFSM_Renumber_t* renumber, GOFSM_t* gofsm){
+	GOFSM_ASSERT(renumber!=NULL);
+	GOFSM_ASSERT(gofsm!=NULL);
+	for(uint8_t j=0; j<gofsm->transitions_count; j++){
+		GOFSM_Transition_t* transition = gofsm->transitions[j];
+		if(!transition->is_any)
+			transition->source_node_index = renumber->to_internal[transition->source_node_index];
+		transition->destination_node_index = renumber->to_internal[transition->destination_node_index];
+	}
+	// цель та же, меняется только её номер: присваивание напрямую, без отмены ожидающего прибытия
+	gofsm->current_node_index = renumber->to_internal[gofsm->current_node_index];
+	gofsm->target_node_index = renumber->to_internal[gofsm->target_node_index];
+	gofsm->is_target_change = 1;
+	// записи кеша планов следуют за своими целями; таблицы сбрасывает GOFSM_Reconfigure
+	GOFSM_Plan_Cache_t* cache = gofsm->plan_cache;
+	if(cache!=NULL)
+		for(uint8_t i=0; i<cache->entries_count; i++)
+			cache->entries[i].target = renumber->to_internal[cache->entries[i].target];
+	GOFSM_Reconfigure(gofsm);
+}
+
+void GOFSM_Renumber_SetCurrent(GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index){
+	GOFSM_SetCurrent(gofsm, renumber->to_internal[node_index]);
+}
+void GOFSM_Renumber_SetTarget(GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index){
+	GOFSM_SetTarget(gofsm, renumber->to_internal[node_index]);
+}
+GOFSM_Node_Index_t GOFSM_Renumber_GetCurrent(const GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber){
+	return renumber->to_external[gofsm->current_node_index];
+}
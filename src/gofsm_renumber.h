@@ -0,0 +1,56 @@
+#ifndef GOFSM_RENUMBER_H
+#define GOFSM_RENUMBER_H
+
+#include <GOFSM/gofsm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Перенумерация нод графа для локальности.
+// Ноды, встречающиеся в переходах, получают плотные внутренние индексы 0..nodes_count-1 в порядке обхода,
+// так что соседи оказываются рядом в таблицах следующих шагов, индексе предшественников и кеше планов.
+// Заодно разреженные пользовательские индексы становятся меньше nodes_capacity, что открывает Index/Table.
+// После GOFSM_Renumber_Apply() переходы, current_node_index и target_node_index хранят внутренние индексы,
+// пользовательские переводятся через таблицы за O(1). Таблица имён остаётся в пользовательских индексах:
+// GOFSM_SetTargetByName у перенумерованного автомата заменяется на GOFSM_Names_Find + GOFSM_Renumber_SetTarget.
+typedef enum{
+	GOFSM_Renumber_Order_Bfs = 0,  // обход в ширину от корня
+	GOFSM_Renumber_Order_Rcm = 1   // обратный Катхилл–Макки: от ноды минимальной степени, соседи по возрастанию степени
+}GOFSM_Renumber_Order_t;
+
+#define GOFSM_RENUMBER_NONE 0xFF
+
+typedef struct{
+	GOFSM_Node_Index_t to_internal[UINT8_MAX+1];
+	GOFSM_Node_Index_t to_external[UINT8_MAX+1];
+	uint8_t nodes_count;
+}GOFSM_Renumber_t;
+
+// Строит перенумерацию по текущему набору переходов. root используется для Order_Bfs.
+// Wildcard-переходы из любой ноды допустимы, пока все используемые ноды ниже nodes_capacity,
+// иначе, как и для wildcard с множеством источников, — GOFSM_Error_Unsupported
+GOFSM_Error_t GOFSM_Renumber_Build(GOFSM_Renumber_t* renumber, const GOFSM_t* gofsm, GOFSM_Renumber_Order_t order, GOFSM_Node_Index_t root);
+// Переписывает ноды переходов, текущую и целевую ноду и цели кеша планов во внутренние индексы.
+// Ожидающий прибытия не уведомляется: цель та же. Переходы переписываются на месте, поэтому
+// другой GOFSM_t с теми же переходами (клон, второй автомат на общих переходах) видит
+// внутренние индексы в своих текущей и целевой ноде и работает неверно
+void GOFSM_Renumber_Apply(const GOFSM_Renumber_t* renumber, GOFSM_t* gofsm);
+
+static inline GOFSM_Node_Index_t GOFSM_Renumber_ToInternal(const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index){
+	return renumber->to_internal[node_index];
+}
+static inline GOFSM_Node_Index_t GOFSM_Renumber_ToExternal(const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index){
+	return renumber->to_external[node_index];
+}
+
+// Работа с пользовательскими индексами у перенумерованного автомата
+void GOFSM_Renumber_SetCurrent(GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index);
+void GOFSM_Renumber_SetTarget(GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber, GOFSM_Node_Index_t node_index);
+GOFSM_Node_Index_t GOFSM_Renumber_GetCurrent(const GOFSM_t* gofsm, const GOFSM_Renumber_t* renumber);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
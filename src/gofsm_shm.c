@@ -0,0 +1,152 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE     // shm_open(), ftruncate()
+#endif
+#include <GOFSM/gofsm_shm.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(GOFSM_Shm_Record_t)==16, "GOFSM_Shm_Record_t layout");
+_Static_assert(sizeof(GOFSM_Shm_Header_t)==32, "GOFSM_Shm_Header_t layout");
+
+static void GOFSM_Shm_Map(GOFSM_Shm_t* shm, void* memory){
+	shm->header = (GOFSM_Shm_Header_t*)memory;
+	shm->records = (GOFSM_Shm_Record_t*)((uint8_t*)memory+sizeof(GOFSM_Shm_Header_t));
+}
+
+GOFSM_Error_t GOFSM_Shm_Create(GOFSM_Shm_t* shm, const char* name, GOFSM_Executor_t* executor){
+	GOFSM_ASSERT(shm!=NULL);
+	GOFSM_ASSERT(name!=NULL);
+	GOFSM_ASSERT(executor!=NULL);
+	shm->executor = executor;
+	shm->header = NULL;
+	shm->records = NULL;
+	shm->size = sizeof(GOFSM_Shm_Header_t)+executor->slots_capacity*sizeof(GOFSM_Shm_Record_t);
+	// читатели прежнего сегмента сохраняют своё отображение, новые увидят чистый сегмент
+	shm_unlink(name);
+	shm->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(shm->fd<0)
+		return GOFSM_Error_IoSetup;
+	void* memory = MAP_FAILED;
+	if(ftruncate(shm->fd, (off_t)shm->size)==0)
+		memory = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+	if(memory==MAP_FAILED){
+		close(shm->fd);
+		shm_unlink(name);
+		return GOFSM_Error_IoSetup;
+	}
+	GOFSM_Shm_Map(shm, memory);
+	// ftruncate обнулил сегмент: все записи свободны, последовательности чётные
+	shm->header->version = GOFSM_SHM_VERSION;
+	shm->header->record_size = sizeof(GOFSM_Shm_Record_t);
+	shm->header->records_capacity = executor->slots_capacity;
+	// magic последним: читатель, увидевший его, видит заполненный заголовок
+	__atomic_store_n(&shm->header->magic, GOFSM_SHM_MAGIC, __ATOMIC_RELEASE);
+	return GOFSM_Error_No;
+}
+void GOFSM_Shm_Destroy(GOFSM_Shm_t* shm, const char* name){
+	GOFSM_Shm_Close(shm);
+	if(name!=NULL)
+		shm_unlink(name);
+}
+
+void GOFSM_Shm_Publish(GOFSM_Shm_t* shm){
+	GOFSM_ASSERT(shm!=NULL && shm->executor!=NULL);
+	const GOFSM_Executor_t* executor = shm->executor;
+	for(GOFSM_Slot_t slot=0; slot<executor->slots_used; slot++){
+		const GOFSM_Executor_Slot_t* entry = executor->slots+slot;
+		const GOFSM_t* gofsm = entry->gofsm;
+		GOFSM_Shm_Record_t state;
+		memset(&state, 0, sizeof(state));
+		state.transition_source = GOFSM_NODE_ANY;
+		state.transition_destination = GOFSM_NODE_ANY;
+		if(gofsm!=NULL){
+			state.current_node_index = gofsm->current_node_index;
+			state.target_node_index = gofsm->target_node_index;
+			if(gofsm->transition_current!=NULL){
+				state.transition_source = gofsm->transition_current->source_node_index;
+				state.transition_destination = gofsm->transition_current->destination_node_index;
+			}
+			state.flags = GOFSM_SHM_FLAG_USED
+				| (gofsm->is_transition_failure ? GOFSM_SHM_FLAG_FAILURE : 0)
+				| (entry->is_parked ? GOFSM_SHM_FLAG_PARKED : 0)
+				| (entry->is_deadline ? GOFSM_SHM_FLAG_DEADLINE : 0);
+		}
+		// писатель единственный: сравнение с сегментом без seqlock, неизменные записи не трогаются
+		GOFSM_Shm_Record_t* record = shm->records+slot;
+		if(record->current_node_index==state.current_node_index && record->target_node_index==state.target_node_index
+			&& record->transition_source==state.transition_source && record->transition_destination==state.transition_destination
+			&& record->flags==state.flags)
+			continue;
+		uint32_t sequence = record->sequence;
+		__atomic_store_n(&record->sequence, sequence+1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		record->current_node_index = state.current_node_index;
+		record->target_node_index = state.target_node_index;
+		record->transition_source = state.transition_source;
+		record->transition_destination = state.transition_destination;
+		record->flags = state.flags;
+		record->changed_tick = executor->now;
+		__atomic_store_n(&record->sequence, sequence+2, __ATOMIC_RELEASE);
+	}
+	if(shm->header->records_count<executor->slots_used)
+		__atomic_store_n(&shm->header->records_count, executor->slots_used, __ATOMIC_RELEASE);
+	__atomic_store_n(&shm->header->tick, executor->now, __ATOMIC_RELAXED);
+}
+
+GOFSM_Error_t GOFSM_Shm_Open(GOFSM_Shm_t* shm, const char* name){
+	GOFSM_ASSERT(shm!=NULL);
+	GOFSM_ASSERT(name!=NULL);
+	shm->executor = NULL;
+	shm->header = NULL;
+	shm->records = NULL;
+	shm->fd = shm_open(name, O_RDONLY, 0);
+	if(shm->fd<0)
+		return GOFSM_Error_IoSetup;
+	struct stat info;
+	void* memory = MAP_FAILED;
+	if(fstat(shm->fd, &info)==0 && (size_t)info.st_size>=sizeof(GOFSM_Shm_Header_t))
+		memory = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, shm->fd, 0);
+	if(memory==MAP_FAILED){
+		close(shm->fd);
+		return GOFSM_Error_IoSetup;
+	}
+	shm->size = (size_t)info.st_size;
+	GOFSM_Shm_Map(shm, memory);
+	const GOFSM_Shm_Header_t* header = shm->header;
+	if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE)!=GOFSM_SHM_MAGIC || header->version!=GOFSM_SHM_VERSION
+		|| header->record_size!=sizeof(GOFSM_Shm_Record_t)
+		|| shm->size<sizeof(GOFSM_Shm_Header_t)+header->records_capacity*sizeof(GOFSM_Shm_Record_t)){
+		GOFSM_Shm_Close(shm);
+		return GOFSM_Error_Unsupported;
+	}
+	return GOFSM_Error_No;
+}
+void GOFSM_Shm_Close(GOFSM_Shm_t* shm){
+	if(shm->header!=NULL)
+		munmap(shm->header, shm->size);
+	if(shm->fd>=0)
+		close(shm->fd);
+	shm->header = NULL;
+	shm->records = NULL;
+	shm->fd = -1;
+}
+
+uint8_t GOFSM_Shm_Read(const GOFSM_Shm_t* shm, GOFSM_Slot_t slot, GOFSM_Shm_Record_t* record, uint16_t max_retries){
+	GOFSM_ASSERT(shm!=NULL && shm->header!=NULL);
+	GOFSM_ASSERT(slot<shm->header->records_capacity);
+	const GOFSM_Shm_Record_t* source = shm->records+slot;
+	for(uint16_t attempt=0; attempt<=max_retries; attempt++){
+		uint32_t sequence = __atomic_load_n(&source->sequence, __ATOMIC_ACQUIRE);
+		if(sequence & 1) continue;
+		memcpy(record, source, sizeof(*record));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&source->sequence, __ATOMIC_RELAXED)==sequence){
+			record->sequence = sequence;
+			return 1;
+		}
+	}
+	return 0;
+}
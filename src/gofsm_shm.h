@@ -0,0 +1,74 @@
+#ifndef GOFSM_SHM_H
+#define GOFSM_SHM_H
+
+#include <GOFSM/gofsm_executor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Состояние автоматов исполнителя в разделяемой памяти POSIX для внешних процессов (мониторинг, UI).
+// Процесс управления после тика вызывает GOFSM_Shm_Publish(): переписываются только изменившиеся записи,
+// каждая под своим seqlock. Читатели отображают сегмент только на чтение и копируют записи без
+// блокировок и системных вызовов; запись, попавшая на обновление, перечитывается.
+// Раскладка стабильна между версиями библиотеки при одном GOFSM_SHM_VERSION. Структуры сегмента
+// не упакованы: счётчик seqlock читается атомарно и должен быть выровнен
+#define GOFSM_SHM_MAGIC 0x4D53464Fu       // "OFSM"
+#define GOFSM_SHM_VERSION 1
+
+#define GOFSM_SHM_FLAG_USED     0x01      // слот занят автоматом
+#define GOFSM_SHM_FLAG_FAILURE  0x02      // последний вызов перехода вернул Failure
+#define GOFSM_SHM_FLAG_PARKED   0x04
+#define GOFSM_SHM_FLAG_DEADLINE 0x08      // у цели есть срок
+
+typedef struct{
+	uint32_t sequence;                    // нечётный — запись обновляется
+	uint8_t current_node_index;
+	uint8_t target_node_index;
+	uint8_t transition_source;            // GOFSM_NODE_ANY — перехода нет
+	uint8_t transition_destination;
+	uint8_t flags;                        // GOFSM_SHM_FLAG_*
+	uint8_t reserved[3];
+	uint32_t changed_tick;                // тик исполнителя последнего изменения
+}GOFSM_Shm_Record_t;
+
+typedef struct{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;                 // sizeof(GOFSM_Shm_Record_t) писателя
+	uint32_t records_capacity;
+	uint32_t records_count;               // записи с индексом не меньше не использовались
+	uint32_t tick;                        // тик последней публикации
+	uint32_t reserved[3];
+}GOFSM_Shm_Header_t;
+
+typedef struct __attribute__((packed)){
+	int fd;
+	size_t size;
+	GOFSM_Shm_Header_t* header;
+	GOFSM_Shm_Record_t* records;          // индекс записи — слот исполнителя
+	GOFSM_Executor_t* executor;           // NULL у читателя
+}GOFSM_Shm_t;
+
+// Сегмент name ("/имя") на slots_capacity записей исполнителя; существующий сегмент пересоздаётся.
+// GOFSM_Error_IoSetup — сегмент не создан
+GOFSM_Error_t GOFSM_Shm_Create(GOFSM_Shm_t* shm, const char* name, GOFSM_Executor_t* executor);
+// Удаляет и имя сегмента: уже подключённые читатели дочитывают последнее опубликованное состояние
+void GOFSM_Shm_Destroy(GOFSM_Shm_t* shm, const char* name);
+// Вызывать после GOFSM_Executor_Tick() и после изменений вне тика
+void GOFSM_Shm_Publish(GOFSM_Shm_t* shm);
+
+// Читатель. GOFSM_Error_IoSetup — сегмента нет, GOFSM_Error_Unsupported — другая версия раскладки
+GOFSM_Error_t GOFSM_Shm_Open(GOFSM_Shm_t* shm, const char* name);
+void GOFSM_Shm_Close(GOFSM_Shm_t* shm);
+static inline uint32_t GOFSM_Shm_Count(const GOFSM_Shm_t* shm){
+	return __atomic_load_n(&shm->header->records_count, __ATOMIC_ACQUIRE);
+}
+// Согласованная копия записи slot. 0 — писатель обновлял запись все max_retries попыток
+uint8_t GOFSM_Shm_Read(const GOFSM_Shm_t* shm, GOFSM_Slot_t slot, GOFSM_Shm_Record_t* record, uint16_t max_retries);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
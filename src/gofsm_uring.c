@@ -0,0 +1,183 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE     // syscall()
+#endif
+#include <GOFSM/gofsm_uring.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Слот перехода, если в нём всё ещё автомат, создавший переход: освобождённый и занятый
+// другим автоматом слот не паркуется и не будится
+static GOFSM_Executor_Slot_t* GOFSM_Io_Slot(GOFSM_Transition_Io_t* io){
+	GOFSM_Executor_t* executor = io->uring->executor;
+	if(io->slot>=executor->slots_used || executor->slots[io->slot].gofsm!=io->gofsm)
+		return NULL;
+	return executor->slots+io->slot;
+}
+
+static GOFSM_Transition_Result_t GOFSM_Io_Function(GOFSM_Transition_t* transition){
+	GOFSM_Transition_Io_t* io = (GOFSM_Transition_Io_t*)transition;
+	GOFSM_Uring_t* uring = io->uring;
+	if(io->status==GOFSM_Io_Done){
+		io->status = GOFSM_Io_Idle;
+		if(io->function!=NULL)
+			return io->function(transition);
+		return io->result>=0 ? GOFSM_Transition_Result_Success : GOFSM_Transition_Result_Failure;
+	}
+	if(io->status==GOFSM_Io_Idle){
+		uint32_t tail = *uring->sq_tail;
+		// очередь заполнена за этот тик: повтор на следующем, без парковки
+		if(tail-__atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE)>=uring->sq_entries)
+			return GOFSM_Transition_Result_Failure;
+		uint32_t index = tail & uring->sq_mask;
+		struct io_uring_sqe* sqe = uring->sqes+index;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = io->opcode;
+		sqe->fd = io->fd;
+		sqe->addr = (uint64_t)(uintptr_t)io->buffer;
+		sqe->off = io->offset;
+		if(io->opcode==IORING_OP_POLL_ADD)
+			sqe->poll32_events = io->length;
+		else
+			sqe->len = io->length;
+		sqe->user_data = (uint64_t)(uintptr_t)io;
+		uring->sq_array[index] = index;
+		__atomic_store_n(uring->sq_tail, tail+1, __ATOMIC_RELEASE);
+		uring->sq_pending++;
+		io->status = GOFSM_Io_InFlight;
+	}
+	// до завершения автомат не опрашивается, слот будит GOFSM_Uring_Tick()
+	GOFSM_Executor_Slot_t* entry = GOFSM_Io_Slot(io);
+	if(entry!=NULL)
+		entry->is_parked = 1;
+	return GOFSM_Transition_Result_Failure;
+}
+
+void GOFSM_Transition_InitIo(GOFSM_Transition_Io_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function, GOFSM_Uring_t* uring, GOFSM_Slot_t slot){
+	GOFSM_ASSERT(transition!=NULL);
+	GOFSM_ASSERT(uring!=NULL);
+	GOFSM_Executor_t* executor = uring->executor;
+	GOFSM_ASSERT(slot<executor->slots_used && executor->slots[slot].gofsm!=NULL);
+	GOFSM_Transition_Init(&transition->transition, source_node_index, destination_node_index, GOFSM_Io_Function);
+	transition->function = function;
+	transition->uring = uring;
+	transition->gofsm = executor->slots[slot].gofsm;
+	transition->slot = slot;
+	// слот хранится по индексу: автомат больше не переносится между исполнителями
+	executor->slots[slot].pins++;
+	transition->opcode = IORING_OP_NOP;
+	transition->status = GOFSM_Io_Idle;
+	transition->fd = -1;
+	transition->buffer = NULL;
+	transition->length = 0;
+	transition->offset = 0;
+	transition->result = 0;
+}
+void GOFSM_Transition_IoRead(GOFSM_Transition_Io_t* transition, int fd, void* buffer, uint32_t length, uint64_t offset){
+	transition->opcode = IORING_OP_READ;
+	transition->fd = fd;
+	transition->buffer = buffer;
+	transition->length = length;
+	transition->offset = offset;
+}
+void GOFSM_Transition_IoWrite(GOFSM_Transition_Io_t* transition, int fd, const void* buffer, uint32_t length, uint64_t offset){
+	transition->opcode = IORING_OP_WRITE;
+	transition->fd = fd;
+	transition->buffer = (void*)buffer;
+	transition->length = length;
+	transition->offset = offset;
+}
+void GOFSM_Transition_IoPoll(GOFSM_Transition_Io_t* transition, int fd, uint32_t events){
+	transition->opcode = IORING_OP_POLL_ADD;
+	transition->fd = fd;
+	transition->buffer = NULL;
+	transition->length = events;
+	transition->offset = 0;
+}
+
+GOFSM_Error_t GOFSM_Uring_Init(GOFSM_Uring_t* uring, GOFSM_Executor_t* executor, uint32_t entries){
+	GOFSM_ASSERT(uring!=NULL);
+	GOFSM_ASSERT(executor!=NULL);
+	memset(uring, 0, sizeof(*uring));
+	uring->executor = executor;
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	uring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	if(uring->fd<0)
+		return GOFSM_Error_IoSetup;
+
+	uring->sq_ring_size = params.sq_off.array+params.sq_entries*sizeof(uint32_t);
+	uring->cq_ring_size = params.cq_off.cqes+params.cq_entries*sizeof(struct io_uring_cqe);
+	uint8_t is_single = (params.features & IORING_FEAT_SINGLE_MMAP)!=0;
+	if(is_single && uring->cq_ring_size>uring->sq_ring_size)
+		uring->sq_ring_size = uring->cq_ring_size;
+	uring->sqes_size = params.sq_entries*sizeof(struct io_uring_sqe);
+
+	uring->sq_ring = mmap(NULL, uring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+	uring->cq_ring = is_single ? uring->sq_ring
+		: mmap(NULL, uring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+	uring->sqes = (struct io_uring_sqe*)mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+	if(uring->sq_ring==MAP_FAILED || uring->cq_ring==MAP_FAILED || (void*)uring->sqes==MAP_FAILED){
+		GOFSM_Uring_Deinit(uring);
+		return GOFSM_Error_IoSetup;
+	}
+
+	uint8_t* sq = (uint8_t*)uring->sq_ring;
+	uint8_t* cq = (uint8_t*)uring->cq_ring;
+	uring->sq_entries = params.sq_entries;
+	uring->sq_head = (uint32_t*)(sq+params.sq_off.head);
+	uring->sq_tail = (uint32_t*)(sq+params.sq_off.tail);
+	uring->sq_mask = *(uint32_t*)(sq+params.sq_off.ring_mask);
+	uring->sq_array = (uint32_t*)(sq+params.sq_off.array);
+	uring->cq_head = (uint32_t*)(cq+params.cq_off.head);
+	uring->cq_tail = (uint32_t*)(cq+params.cq_off.tail);
+	uring->cq_mask = *(uint32_t*)(cq+params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe*)(cq+params.cq_off.cqes);
+	return GOFSM_Error_No;
+}
+void GOFSM_Uring_Deinit(GOFSM_Uring_t* uring){
+	if(uring->sqes!=NULL && (void*)uring->sqes!=MAP_FAILED)
+		munmap(uring->sqes, uring->sqes_size);
+	if(uring->cq_ring!=NULL && uring->cq_ring!=MAP_FAILED && uring->cq_ring!=uring->sq_ring)
+		munmap(uring->cq_ring, uring->cq_ring_size);
+	if(uring->sq_ring!=NULL && uring->sq_ring!=MAP_FAILED)
+		munmap(uring->sq_ring, uring->sq_ring_size);
+	if(uring->fd>=0)
+		close(uring->fd);
+	uring->sqes = NULL;
+	uring->cq_ring = NULL;
+	uring->sq_ring = NULL;
+	uring->fd = -1;
+}
+
+// Завершения читаются из отображённой очереди, системный вызов не нужен
+static void GOFSM_Uring_Reap(GOFSM_Uring_t* uring){
+	uint32_t head = *uring->cq_head;
+	uint32_t tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+	for(; head!=tail; head++){
+		struct io_uring_cqe* cqe = uring->cqes+(head & uring->cq_mask);
+		GOFSM_Transition_Io_t* io = (GOFSM_Transition_Io_t*)(uintptr_t)cqe->user_data;
+		io->result = cqe->res;
+		io->status = GOFSM_Io_Done;
+		GOFSM_Executor_Slot_t* entry = GOFSM_Io_Slot(io);
+		if(entry!=NULL)
+			entry->is_parked = 0;
+		uring->stats.completed++;
+	}
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+void GOFSM_Uring_Tick(GOFSM_Uring_t* uring){
+	GOFSM_ASSERT(uring!=NULL);
+	GOFSM_Uring_Reap(uring);
+	GOFSM_Executor_Tick(uring->executor);
+	if(uring->sq_pending==0) return;
+	uring->stats.enters++;
+	// EAGAIN/EBUSY — ядро не приняло запросы сейчас, они остаются в очереди до следующего тика
+	long submitted = syscall(__NR_io_uring_enter, uring->fd, uring->sq_pending, 0, 0, NULL, 0);
+	if(submitted<=0) return;
+	uring->sq_pending -= (uint32_t)submitted;
+	uring->stats.submitted += (uint32_t)submitted;
+}
@@ -0,0 +1,97 @@
+#ifndef GOFSM_URING_H
+#define GOFSM_URING_H
+
+#include <GOFSM/gofsm_executor.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Переходы ввода-вывода через io_uring (Linux 5.6+), без liburing — кольца отображаются напрямую.
+// Переход ставит запрос чтения, записи или ожидания готовности дескриптора в очередь кольца и паркует
+// свой слот исполнителя. GOFSM_Uring_Tick() забирает завершения из отображённой очереди без
+// системного вызова, будит слоты, выполняет тик исполнителя и одним io_uring_enter отправляет
+// все запросы, поставленные за тик.
+typedef enum{
+	GOFSM_Io_Idle = 0,
+	GOFSM_Io_InFlight = 1,
+	GOFSM_Io_Done = 2
+}GOFSM_Io_Status_t;
+
+struct GOFSM_Uring_t;
+typedef struct __attribute__((packed)){
+	GOFSM_Transition_t transition;
+	// Вызывается с готовым результатом (поле result). NULL — Success при result>=0.
+	// Failure ставит запрос заново
+	GOFSM_Transition_Function_t function;
+	struct GOFSM_Uring_t* uring;
+	GOFSM_t* gofsm;                   // автомат слота на момент GOFSM_Transition_InitIo
+	GOFSM_Slot_t slot;
+	uint8_t opcode;
+	uint8_t status;                   // GOFSM_Io_Status_t
+	int fd;
+	void* buffer;
+	uint32_t length;                  // для ожидания — маска событий poll
+	uint64_t offset;
+	int32_t result;                   // результат запроса: байты или -errno
+}GOFSM_Transition_Io_t;
+
+typedef struct __attribute__((packed)){
+	uint32_t submitted;               // запросы, принятые ядром
+	uint32_t completed;
+	uint32_t enters;                  // системные вызовы io_uring_enter
+}GOFSM_Uring_Stats_t;
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+typedef struct __attribute__((packed)) GOFSM_Uring_t{
+	int fd;
+	uint32_t sq_entries;
+	uint32_t sq_mask;
+	uint32_t cq_mask;
+	uint32_t sq_pending;              // поставлены в очередь, ещё не отправлены
+	uint32_t* sq_head;
+	uint32_t* sq_tail;
+	uint32_t* sq_array;
+	uint32_t* cq_head;
+	uint32_t* cq_tail;
+	struct io_uring_sqe* sqes;
+	struct io_uring_cqe* cqes;
+	void* sq_ring;
+	void* cq_ring;                    // совпадает с sq_ring при общем отображении
+	size_t sq_ring_size;
+	size_t cq_ring_size;
+	size_t sqes_size;
+	GOFSM_Executor_t* executor;
+	GOFSM_Uring_Stats_t stats;
+}GOFSM_Uring_t;
+
+// Кольцо на entries запросов (степень двойки). Очередь завершений в два раза больше.
+// GOFSM_Error_IoSetup — ядро без io_uring или не хватило памяти/прав
+GOFSM_Error_t GOFSM_Uring_Init(GOFSM_Uring_t* uring, GOFSM_Executor_t* executor, uint32_t entries);
+// Запросы в работе отменяются ядром; их переходы не использовать повторно без GOFSM_Transition_InitIo()
+void GOFSM_Uring_Deinit(GOFSM_Uring_t* uring);
+
+// Регистрируется как обычный переход в автомате слота slot: GOFSM_AddTransition(gofsm, &io->transition).
+// Слот должен быть занят; автомат запоминается, и после удаления слота завершение его не будит,
+// даже если слот занял другой автомат. Слот закрепляется: GOFSM_Executor_Migrate его не переносит.
+// Переход и буфер не освобождать, пока запрос в работе. Если план сменился, пока запрос в работе,
+// результат забирается следующим вызовом перехода
+void GOFSM_Transition_InitIo(GOFSM_Transition_Io_t* transition, GOFSM_Node_Index_t source_node_index, GOFSM_Node_Index_t destination_node_index, GOFSM_Transition_Function_t function, GOFSM_Uring_t* uring, GOFSM_Slot_t slot);
+// Запрос, который переход ставит при следующем вызове; offset — (uint64_t)-1 для текущей позиции
+void GOFSM_Transition_IoRead(GOFSM_Transition_Io_t* transition, int fd, void* buffer, uint32_t length, uint64_t offset);
+void GOFSM_Transition_IoWrite(GOFSM_Transition_Io_t* transition, int fd, const void* buffer, uint32_t length, uint64_t offset);
+// Однократное ожидание событий poll (POLLIN, POLLOUT...), result — сработавшие события
+void GOFSM_Transition_IoPoll(GOFSM_Transition_Io_t* transition, int fd, uint32_t events);
+
+// Завершения -> GOFSM_Executor_Tick() -> отправка. Не более одного системного вызова за тик,
+// ни одного, если за тик ничего не поставлено
+void GOFSM_Uring_Tick(GOFSM_Uring_t* uring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
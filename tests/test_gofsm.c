@@ -0,0 +1,369 @@
+// Хостовые тесты GOFSM: make -C tests
+// Каждый сценарий — отдельная функция, провалы считаются и печатаются, код выхода ненулевой при провале.
+#include <GOFSM/gofsm.h>
+#include <GOFSM/gofsm_executor.h>
+#include <GOFSM/gofsm_renumber.h>
+#include <stdio.h>
+#include <string.h>
+
+// Исходный BFS, объявлен только в gofsm.c. Служит эталоном для остальных планировщиков
+GOFSM_Transition_t* GOFSM_SearchNextStep(GOFSM_t* gofsm);
+
+static unsigned test_failures;
+
+#define CHECK(condition) do{ \
+	if(!(condition)){ \
+		test_failures++; \
+		fprintf(stderr, "%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #condition); \
+	} \
+}while(0)
+
+static uint32_t test_seed = 12345;
+static uint32_t Test_Random(void){
+	test_seed = test_seed*1103515245u + 12345u;
+	return test_seed >> 16;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Планировщики: на случайных графах все дают тот же первый шаг, что и исходный BFS,
+// и доходят до цели за кратчайшее число шагов либо не двигаются, если цель недостижима
+
+#define PLAN_NODES_MAX 48
+#define PLAN_TRANSITIONS_MAX 160
+#define PLAN_PLANNERS 5
+
+// Кратчайшее расстояние по доступным переходам, 0xFF — недостижимо
+static uint8_t Plan_Distance(GOFSM_Transition_t* transitions, int transitions_count, int from, int to){
+	uint8_t distance[PLAN_NODES_MAX];
+	uint8_t queue[PLAN_NODES_MAX];
+	int head = 0, tail = 0;
+	memset(distance, 0xFF, sizeof(distance));
+	distance[from] = 0;
+	queue[tail++] = (uint8_t)from;
+	while(head<tail){
+		int node = queue[head++];
+		for(int i=0; i<transitions_count; i++){
+			GOFSM_Transition_t* t = &transitions[i];
+			if(t->state!=GOFSM_Transition_State_Available || t->source_node_index!=node) continue;
+			if(distance[t->destination_node_index]!=0xFF) continue;
+			distance[t->destination_node_index] = distance[node]+1;
+			queue[tail++] = t->destination_node_index;
+		}
+	}
+	return distance[to];
+}
+
+static void Test_Planners(void){
+	static GOFSM_Transition_t transitions[PLAN_TRANSITIONS_MAX];
+	for(int trial=0; trial<400; trial++){
+		int nodes = 2 + Test_Random()%(PLAN_NODES_MAX-1);
+		int transitions_count = 1 + Test_Random()%PLAN_TRANSITIONS_MAX;
+		GOFSM_t reference;
+		GOFSM_t machines[PLAN_PLANNERS];
+		GOFSM_Init(&reference, transitions_count, nodes);
+		for(int p=0; p<PLAN_PLANNERS; p++){
+			GOFSM_Init(&machines[p], transitions_count, nodes);
+			GOFSM_SetPlanner(&machines[p], (GOFSM_Planner_t)p);
+		}
+		for(int i=0; i<transitions_count; i++){
+			GOFSM_Transition_Init(&transitions[i], Test_Random()%nodes, Test_Random()%nodes, NULL);
+			if(Test_Random()%4==0) transitions[i].state = GOFSM_Transition_State_Blocked;
+			GOFSM_AddTransition(&reference, &transitions[i]);
+			for(int p=0; p<PLAN_PLANNERS; p++) GOFSM_AddTransition(&machines[p], &transitions[i]);
+		}
+		for(int query=0; query<40; query++){
+			int current = Test_Random()%nodes;
+			int target = Test_Random()%nodes;
+			if(current==target) continue;
+			// Смена графа между запросами: таблицы и индексы обязаны перестроиться
+			if(query%8==7){
+				GOFSM_Transition_t* t = &transitions[Test_Random()%transitions_count];
+				GOFSM_Transition_SetState(&reference, t, !t->state);
+			}
+			uint8_t distance = Plan_Distance(transitions, transitions_count, current, target);
+			GOFSM_SetCurrent(&reference, current);
+			GOFSM_SetTarget(&reference, target);
+			GOFSM_Transition_t* first = GOFSM_SearchNextStep(&reference);
+			CHECK((first==NULL) == (distance==0xFF));
+			for(int p=0; p<PLAN_PLANNERS; p++){
+				GOFSM_t* m = &machines[p];
+				GOFSM_SetCurrent(m, current);
+				GOFSM_SetTarget(m, target);
+				GOFSM_OnTick(m);
+				CHECK(m->transition_current==first);
+				int steps = m->current_node_index!=current;
+				while(m->current_node_index!=target && m->transition_current!=NULL && steps<=nodes){
+					GOFSM_OnTick(m);
+					steps++;
+				}
+				if(distance==0xFF) CHECK(m->current_node_index==current);
+				else CHECK(m->current_node_index==target && steps==distance);
+			}
+		}
+		GOFSM_Deinit(&reference);
+		for(int p=0; p<PLAN_PLANNERS; p++) GOFSM_Deinit(&machines[p]);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------
+// Барьеры
+
+static GOFSM_t barrier_machine;
+static GOFSM_Transition_t barrier_plain;
+static GOFSM_Transition_Result_t Barrier_Unblock(GOFSM_Transition_t* transition){
+	(void)transition;
+	GOFSM_Transition_SetState(&barrier_machine, &barrier_plain, GOFSM_Transition_State_Available);
+	return GOFSM_Transition_Result_Success;
+}
+
+static void Test_Barrier_Remove(void){
+	GOFSM_Executor_t executor;
+	GOFSM_Barrier_t barrier;
+	GOFSM_t machines[2];
+	GOFSM_Transition_Barrier_t transitions[2];
+	GOFSM_Slot_t slots[2];
+	GOFSM_Executor_Init(&executor, 4, 8);
+	GOFSM_Barrier_Init(&barrier, 2);
+	for(int i=0; i<2; i++){
+		GOFSM_Init(&machines[i], 2, 4);
+		GOFSM_Transition_InitBarrier(&transitions[i], 0, 1, NULL);
+		GOFSM_AddTransition(&machines[i], &transitions[i].transition);
+		GOFSM_Executor_Add(&executor, &machines[i], &slots[i]);
+		GOFSM_Executor_AddBarrier(&executor, &barrier, slots[i], &transitions[i]);
+	}
+	GOFSM_Executor_SetTarget(&executor, slots[0], 1, 0, 0);
+	GOFSM_Executor_Tick(&executor);
+	CHECK(barrier.arrived_count==1);
+	// Удалённый участник забирает своё прибытие и не держит остальных
+	GOFSM_Executor_Remove(&executor, slots[0]);
+	CHECK(barrier.arrived_count==0 && barrier.members_count==1);
+	// Новый автомат на освободившемся слоте не становится участником
+	GOFSM_t other;
+	GOFSM_Slot_t other_slot;
+	GOFSM_Init(&other, 2, 4);
+	GOFSM_Executor_Add(&executor, &other, &other_slot);
+	CHECK(other_slot==slots[0]);
+	GOFSM_Executor_SetTarget(&executor, slots[1], 1, 0, 0);
+	for(int k=0; k<3; k++) GOFSM_Executor_Tick(&executor);
+	CHECK(machines[1].current_node_index==1 && barrier.fired==1 && other.current_node_index==0);
+	GOFSM_Barrier_Deinit(&barrier);
+	CHECK(executor.barriers==NULL);
+	GOFSM_Executor_Deinit(&executor);
+	GOFSM_Deinit(&other);
+	for(int i=0; i<2; i++) GOFSM_Deinit(&machines[i]);
+}
+
+static void Test_Barrier_Stale_Release(void){
+	GOFSM_Executor_t executor;
+	GOFSM_Barrier_t barrier;
+	GOFSM_t machine_b, machine_c;
+	GOFSM_Transition_Barrier_t transition_a, transition_b;
+	GOFSM_Transition_t transition_c;
+	GOFSM_Slot_t slot_a, slot_b, slot_c;
+	GOFSM_Executor_Init(&executor, 4, 8);
+	GOFSM_Barrier_Init(&barrier, 2);
+	GOFSM_Init(&barrier_machine, 4, 4);
+	GOFSM_Init(&machine_b, 4, 4);
+	GOFSM_Init(&machine_c, 4, 4);
+	// Обычный переход 0->1 стоит первым и заблокирован, поэтому A идёт через барьер
+	GOFSM_Transition_Init(&barrier_plain, 0, 1, NULL);
+	GOFSM_AddTransition(&barrier_machine, &barrier_plain);
+	GOFSM_Transition_SetState(&barrier_machine, &barrier_plain, GOFSM_Transition_State_Blocked);
+	GOFSM_Transition_InitBarrier(&transition_a, 0, 1, NULL);
+	GOFSM_AddTransition(&barrier_machine, &transition_a.transition);
+	GOFSM_Transition_InitBarrier(&transition_b, 0, 1, NULL);
+	GOFSM_AddTransition(&machine_b, &transition_b.transition);
+	// C в том же тике открывает A обычный переход — A уходит с барьерного ребра
+	GOFSM_Transition_Init(&transition_c, 0, 1, Barrier_Unblock);
+	GOFSM_AddTransition(&machine_c, &transition_c);
+	GOFSM_Executor_Add(&executor, &barrier_machine, &slot_a);
+	GOFSM_Executor_Add(&executor, &machine_b, &slot_b);
+	GOFSM_Executor_Add(&executor, &machine_c, &slot_c);
+	GOFSM_Executor_AddBarrier(&executor, &barrier, slot_a, &transition_a);
+	GOFSM_Executor_AddBarrier(&executor, &barrier, slot_b, &transition_b);
+	GOFSM_Executor_SetTarget(&executor, slot_a, 1, 0, 0);
+	GOFSM_Executor_Tick(&executor);
+	CHECK(barrier.arrived_count==1);
+	GOFSM_Executor_SetTarget(&executor, slot_b, 1, 0, 0);
+	GOFSM_Executor_SetTarget(&executor, slot_c, 1, 0, 0);
+	GOFSM_Executor_Tick(&executor);
+	CHECK(barrier.fired==1);
+	// Отпускание относится к одному срабатыванию: повторный заход на барьер ждёт нового
+	GOFSM_Transition_SetState(&barrier_machine, &barrier_plain, GOFSM_Transition_State_Blocked);
+	GOFSM_SetCurrent(&barrier_machine, 0);
+	GOFSM_SetTarget(&barrier_machine, 1);
+	for(int k=0; k<3; k++) GOFSM_Executor_Tick(&executor);
+	CHECK(barrier_machine.current_node_index==0 && barrier.fired==1);
+	GOFSM_Barrier_Deinit(&barrier);
+	GOFSM_Executor_Deinit(&executor);
+	GOFSM_Deinit(&barrier_machine);
+	GOFSM_Deinit(&machine_b);
+	GOFSM_Deinit(&machine_c);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Ожидания: оба индекса и счётчики слотов согласованы при случайных WaitFor/Unwait,
+// Remove снимает ожидания слота, закреплённый ожиданием слот не мигрирует
+
+#define WAIT_MACHINES 6
+#define WAIT_TRANSITIONS 5
+#define WAIT_CAPACITY 7
+GOFSM_WAITS_STATIC_ALLOCATE(static, test_waits, WAIT_CAPACITY);
+
+static void Test_Waits(void){
+	static GOFSM_t machines[WAIT_MACHINES];
+	static GOFSM_Transition_t transitions[WAIT_MACHINES][WAIT_TRANSITIONS];
+	GOFSM_Executor_t executor, other;
+	GOFSM_Executor_Init(&executor, WAIT_MACHINES, 8);
+	GOFSM_Executor_Init(&other, WAIT_MACHINES, 8);
+	GOFSM_Waits_InitStatic(&test_waits);
+	GOFSM_Executor_SetWaits(&executor, &test_waits);
+	for(int i=0; i<WAIT_MACHINES; i++){
+		GOFSM_Init(&machines[i], 8, WAIT_TRANSITIONS+1);
+		for(int j=0; j<WAIT_TRANSITIONS; j++){
+			GOFSM_Transition_Init(&transitions[i][j], j, j+1, NULL);
+			GOFSM_AddTransition(&machines[i], &transitions[i][j]);
+		}
+		GOFSM_Executor_Add(&executor, &machines[i], NULL);
+	}
+	for(int iteration=0; iteration<20000; iteration++){
+		int i = Test_Random()%WAIT_MACHINES;
+		int j = Test_Random()%WAIT_TRANSITIONS;
+		if(Test_Random()%2){
+			GOFSM_Error_t error = GOFSM_Executor_WaitFor(&executor, i, &transitions[i][j], Test_Random()%WAIT_MACHINES, Test_Random()%8);
+			CHECK(error==GOFSM_Error_No || error==GOFSM_Error_OwerstackWaits);
+		}else{
+			GOFSM_Executor_Unwait(&executor, &transitions[i][j]);
+		}
+		unsigned counted = 0;
+		unsigned used = 0;
+		for(int s=0; s<WAIT_MACHINES; s++) counted += executor.slots[s].waits;
+		for(int k=0; k<WAIT_CAPACITY; k++) used += test_waits.waits[k].transition!=NULL;
+		// каждое ожидание учтено у ждущего слота и у слота, которого ждут
+		CHECK(used==test_waits.waits_count && counted==2*used);
+	}
+	for(int i=0; i<WAIT_MACHINES; i++){
+		for(int j=0; j<WAIT_TRANSITIONS; j++) GOFSM_Executor_Unwait(&executor, &transitions[i][j]);
+	}
+	CHECK(test_waits.waits_count==0);
+	for(int s=0; s<WAIT_MACHINES; s++) CHECK(executor.slots[s].waits==0);
+	GOFSM_Executor_WaitFor(&executor, 0, &transitions[0][0], 1, 3);
+	CHECK(GOFSM_Executor_Migrate(&executor, 1, &other, NULL)==GOFSM_Error_Unsupported);
+	GOFSM_Executor_Remove(&executor, 0);
+	CHECK(test_waits.waits_count==0 && executor.slots[1].waits==0);
+	CHECK(GOFSM_Executor_Migrate(&executor, 1, &other, NULL)==GOFSM_Error_No);
+	GOFSM_Executor_Deinit(&executor);
+	GOFSM_Executor_Deinit(&other);
+	for(int i=0; i<WAIT_MACHINES; i++) GOFSM_Deinit(&machines[i]);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Resume: таблица следующих шагов построена для прежней цели и должна перестроиться
+
+static void Test_Resume(void){
+	GOFSM_t machine;
+	GOFSM_Transition_t transitions[4];
+	const int edges[4][2] = {{0,1}, {1,2}, {0,4}, {4,3}};
+	GOFSM_Init(&machine, 5, 5);
+	GOFSM_SetPlanner(&machine, GOFSM_Planner_Table);
+	for(int i=0; i<4; i++){
+		GOFSM_Transition_Init(&transitions[i], edges[i][0], edges[i][1], NULL);
+		GOFSM_AddTransition(&machine, &transitions[i]);
+	}
+	GOFSM_SetTarget(&machine, 2);
+	for(int k=0; k<4; k++) GOFSM_OnTick(&machine);
+	CHECK(machine.current_node_index==2);
+	GOFSM_Resume(&machine, 0, 3, &transitions[2]);
+	CHECK(machine.is_table_valid==0);
+	for(int k=0; k<4; k++) GOFSM_OnTick(&machine);
+	CHECK(machine.current_node_index==3);
+	// SetState виден клону через эпоху графа
+	GOFSM_t clone;
+	GOFSM_Clone(&clone, &machine);
+	uint32_t seen = clone.graph_epoch_seen;
+	GOFSM_Transition_SetState(&machine, &transitions[0], GOFSM_Transition_State_Blocked);
+	CHECK(machine.graph_epoch!=seen);
+	GOFSM_Deinit(&clone);
+	GOFSM_Deinit(&machine);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Dispatch у клона видит переход, добавленный владельцу после клонирования
+
+GOFSM_EVENTS_STATIC_ALLOCATE(static, test_events, 2, 8);
+
+static void Test_Clone_Dispatch(void){
+	GOFSM_t owner, clone;
+	GOFSM_Transition_t first, second;
+	GOFSM_Init(&owner, 8, 8);
+	GOFSM_Transition_Init(&first, 0, 1, NULL);
+	GOFSM_Transition_SetEvent(&first, 0);
+	GOFSM_AddTransition(&owner, &first);
+	GOFSM_Events_InitStatic(&test_events);
+	GOFSM_SetEvents(&owner, &test_events);
+	GOFSM_Clone(&clone, &owner);
+	GOFSM_Transition_Init(&second, 0, 2, NULL);
+	GOFSM_Transition_SetEvent(&second, 1);
+	GOFSM_AddTransition(&owner, &second);
+	CHECK(GOFSM_Dispatch(&clone, 1)==GOFSM_Error_No && clone.transition_current==&second);
+	CHECK(GOFSM_Dispatch(&owner, 1)==GOFSM_Error_No);
+	GOFSM_OnTick(&clone);
+	CHECK(clone.current_node_index==2);
+	GOFSM_Deinit(&clone);
+	GOFSM_Deinit(&owner);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Перенумерация: wildcard с нодой за nodes_capacity отклоняется, после Apply путь тот же
+
+static void Test_Renumber(void){
+	GOFSM_t machine;
+	GOFSM_Transition_t plain;
+	GOFSM_Transition_Any_t any;
+	GOFSM_Renumber_t renumber;
+	GOFSM_Init(&machine, 8, 8);
+	GOFSM_Transition_Init(&plain, 3, 200, NULL);
+	GOFSM_AddTransition(&machine, &plain);
+	GOFSM_Transition_InitAny(&any, NULL, 5, NULL);
+	GOFSM_AddTransition(&machine, &any.transition);
+	GOFSM_SetCurrent(&machine, 3);
+	GOFSM_SetTarget(&machine, 3);
+	CHECK(GOFSM_Renumber_Build(&renumber, &machine, GOFSM_Renumber_Order_Bfs, 3)==GOFSM_Error_Unsupported);
+	GOFSM_RemoveTransition(&machine, &plain);
+	GOFSM_RemoveTransition(&machine, &any.transition);
+	GOFSM_Deinit(&machine);
+
+	// Цепочка 7->2->6->0 без wildcard: пользовательские индексы сохраняются снаружи
+	GOFSM_Transition_t chain[3];
+	const int edges[3][2] = {{7,2}, {2,6}, {6,0}};
+	GOFSM_Init(&machine, 4, 8);
+	for(int i=0; i<3; i++){
+		GOFSM_Transition_Init(&chain[i], edges[i][0], edges[i][1], NULL);
+		GOFSM_AddTransition(&machine, &chain[i]);
+	}
+	GOFSM_SetCurrent(&machine, 7);
+	GOFSM_SetTarget(&machine, 7);
+	CHECK(GOFSM_Renumber_Build(&renumber, &machine, GOFSM_Renumber_Order_Bfs, 7)==GOFSM_Error_No);
+	GOFSM_Renumber_Apply(&renumber, &machine);
+	CHECK(GOFSM_Renumber_GetCurrent(&machine, &renumber)==7);
+	GOFSM_Renumber_SetTarget(&machine, &renumber, 0);
+	for(int k=0; k<4; k++) GOFSM_OnTick(&machine);
+	CHECK(GOFSM_Renumber_GetCurrent(&machine, &renumber)==0);
+	GOFSM_Deinit(&machine);
+}
+
+int main(void){
+	Test_Planners();
+	Test_Barrier_Remove();
+	Test_Barrier_Stale_Release();
+	Test_Waits();
+	Test_Resume();
+	Test_Clone_Dispatch();
+	Test_Renumber();
+	if(test_failures!=0){
+		fprintf(stderr, "%u check(s) failed\n", test_failures);
+		return 1;
+	}
+	puts("ok");
+	return 0;
+}